@@ -0,0 +1,22 @@
+#ifndef LOG_FORMATS_H
+#define LOG_FORMATS_H
+
+#include "dlog.h"
+
+// Mensagens do Lab2. A ordem define o ID gravado no quadro: o decodificador do host
+// (host/link_cat.cpp) e compilado com este mesmo arquivo, entao so acrescente no final.
+#define LOG_FORMATS(X) \
+    X(LOG_LDR_STATUS,       "LDR Value: %u, Duty cycle: %u\r\n") \
+    X(LOG_PARSER,           "Parser: %u linhas, media %u ciclos, pior %u ciclos\r\n") \
+    X(LOG_INVALID,          "Comando invalido\r\n") \
+    X(LOG_ADC,              "ADC: %u amostras, %u perdidas, jitter %u ciclos\r\n") \
+    X(LOG_FILTER_STAGE,     "Filtro %u (tipo %u): %u ciclos por 100 amostras\r\n") \
+    X(LOG_TELEMETRY,        "Telemetria: %u leituras, %u enviadas, %u por silencio\r\n") \
+    X(LOG_CAPTURE,          "Captura: %u registros gravados, %u bytes em uso, %u setores apagados\r\n") \
+    X(LOG_PID,              "PID: setpoint %u, luz %u, duty %u\r\n") \
+    X(LOG_PID_LATENCY,      "Latencia amostra->PWM: media %u, pior %u ciclos (%u no filtro e no PID)\r\n") \
+    X(LOG_PID_STATS,        "PID: %u passos saturados, %u com o integrador travado, %u periodos perdidos\r\n")
+
+enum { LOG_FORMATS(DLOG_ENUM) LOG_COUNT };
+
+#endif // LOG_FORMATS_H
@@ -1,18 +1,47 @@
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
+#include <stddef.h>
 #include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/gpio.h"
 #include "driverlib/pwm.h"
 #include "driverlib/uart.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/interrupt.h"
-#include "driverlib/timer.h"
-#include "driverlib/adc.h"
-
-#define ADC_SEQUENCER 3         // Sequenciador do ADC para uma única amostra
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "cmd_parser.h"
+#include "timing.h"
+#include "dlog.h"
+#include "link.h"
+#include "adc_acq.h"
+#include "filter.h"
+#include "change_gate.h"
+#include "flash_log.h"
+#include "pid.h"
+#include "log_formats.h"
+
+#define ADC_RATE_HZ   100       // Amostras do LDR por segundo (disparadas pelo Timer0)
+#define ADC_OVERSAMPLE 16       // Conversoes somadas pelo hardware em cada amostra
+#define LDR_MEDIAN     3        // Mediana contra leituras isoladas fora da curva
+#define LDR_EMA_ALPHA  3277     // EMA de 0,1 (Q15): constante de tempo de ~100 ms a 100 Hz
+#define LDR_DEADBAND   20       // Variacao do LDR (contagens do ADC) que vale uma amostra de telemetria
+#define LDR_MIN_INTERVAL_MS 50  // No maximo 20 amostras de telemetria por segundo
+#define LDR_MAX_SILENCE_MS 1000 // Sem mudanca, uma amostra por segundo
+#define CAPTURE_TAG_LDR 1       // Tag dos blocos de leituras cruas no log em flash
 #define PWM_FREQUENCY 12000     // Frequência do PWM
+#define LDR_FULL_SCALE 4095     // A leitura do LDR sobe quando escurece: luz = 4095 - leitura
+#define LIGHT_SETPOINT 2048     // Luz mantida pelo controle no boot (comando "pid <luz>")
+
+// Ganhos do PID por faixa de setpoint, em ticks do PWM por contagem de luz. O LDR responde
+// menos com pouca luz, entao as faixas escuras pedem mais ganho. Convertidos para o periodo
+// de 10 ms em tempo de compilacao.
+static const PidGainStep g_psLightGains[] = {
+    {1024,           PID_GAINS(1.5, 6.0, 0.010, ADC_RATE_HZ)},
+    {2560,           PID_GAINS(1.0, 4.0, 0.010, ADC_RATE_HZ)},
+    {LDR_FULL_SCALE, PID_GAINS(0.6, 2.5, 0.005, ADC_RATE_HZ)},
+};
 
 
 #define LED_PORTN GPIO_PORTN_BASE   // LEDs 1 e 2
@@ -26,39 +55,96 @@
 
 // Variáveis Globais
 uint32_t SysClock;
-volatile uint32_t g_ui32LDRValue = 0;     // Valor lido do LDR
+volatile uint32_t g_ui32LDRValue = 0;     // Valor do LDR ja filtrado
+volatile uint32_t g_ui32LDRRaw = 0;       // Leitura crua, para a captura
 volatile bool g_bNewLDRValue = false;     // Flag para indicar novo valor do LDR disponível
-uint32_t g_ui32PWMDutyCycle = 0;          // Duty cycle atual
+volatile uint32_t g_ui32PWMDutyCycle = 0; // Duty cycle atual, escrito pelo controle na ISR do ADC
+uint32_t g_ui32PWMPeriod;                 // Periodo do PWM em ticks, lido uma vez no SetupPWM
+Pid g_sLightPid;                          // So a ISR do ADC mexe
+volatile int32_t g_i32LightSetpoint = LIGHT_SETPOINT;  // Pedido pelo comando, aplicado na ISR
+// Latencia da malha, do disparo da amostra pelo Timer0 ate o PWM atualizado (ciclos)
+volatile uint32_t g_ui32LatencySum = 0;
+volatile uint32_t g_ui32LatencyCount = 0;
+volatile uint32_t g_ui32LatencyMax = 0;
+volatile uint32_t g_ui32ComputeMax = 0;  // Parte gasta no filtro e no PID
+// Apagar um setor da flash para a busca de instrucoes por alguns ms: a ISR do controle atrasa
+// e perde periodos, contados aqui pelo intervalo entre amostras
+uint32_t g_ui32SamplePeriod;              // Ciclos entre disparos do Timer0
+uint32_t g_ui32LastSample;                // TimingNow da amostra anterior
+bool g_bSamplePrimed = false;
+volatile uint32_t g_ui32MissedPeriods = 0;
+bool g_bVerbose = true;                   // Imprime cada leitura do LDR
+FilterChain g_sLDRFilter;                 // Filtra a leitura antes do PID (na ISR do ADC)
+ChangeGate g_sLDRGate;                    // So envia telemetria quando a leitura muda
+uint32_t g_ui32SentStep = UINT32_MAX;     // Quarto do duty (0 a 3) da ultima amostra enviada
+volatile uint32_t g_ui32Millis = 0;       // Relogio em ms, avancado a cada amostra do ADC
+CmdParser g_sCmdParser;                   // Comandos recebidos pela UART
+bool g_bCapture = false;                  // Grava cada leitura crua no log em flash
+FlashLogBlock g_sCaptureBlock;            // Leituras ainda em RAM, gravadas a cada bloco cheio
+bool g_bDumping = false;                  // "dump" em andamento
+bool g_bErasing = false;                  // "erase" em andamento, um setor por passada do laco
+FlashLogCursor g_sDumpCursor;
+
+// Amostra enviada no canal de telemetria (little-endian, 8 bytes)
+typedef struct {
+    uint32_t ui32Time;      // Ciclos do DWT (common/timing.h)
+    uint16_t ui16LDR;       // Leitura do ADC, 0 a 4095
+    uint16_t ui16Duty;      // Largura do pulso do PWM em ticks
+} tLDRSample;
 
 // Prototipos
 void SetupUart(void);
-void SetupTimer(void);
 void SetupADC(void);
 void SetupPWM(void);
-void Timer0IntHandler(void);
-void UARTSend(const char *pui8Buffer);
+void LDRSampleReady(uint32_t ui32Sample);
 void ProcessLDRValue(uint32_t ldrValue);
+uint32_t FilterLDR(uint32_t ui32Value);
 void SetupLEDs(void);
+void ProcessCommands(void);
+void DrainLog(void);
+void DumpCapture(void);
 
 int main(void) {
     // Configuração do clock do sistema
     SysClock = SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN |
                                    SYSCTL_USE_PLL | SYSCTL_CFG_VCO_480), 120000000);
 
+    TimingInit(SysClock);
+    FlashLogInit();
     SetupUart();
-    SetupTimer();
-    SetupADC();
+    FilterChainInit(&g_sLDRFilter);
+    FilterChainAddMedian(&g_sLDRFilter, LDR_MEDIAN);
+    FilterChainAddEma(&g_sLDRFilter, LDR_EMA_ALPHA);
+    const ChangeGateConfig sGateConfig = {.absolute = LDR_DEADBAND, .minIntervalMs = LDR_MIN_INTERVAL_MS, .maxSilenceMs = LDR_MAX_SILENCE_MS};
+    ChangeGateInit(&g_sLDRGate, &sGateConfig);
     SetupPWM();
+    PidInit(&g_sLightPid, g_psLightGains, sizeof(g_psLightGains) / sizeof(g_psLightGains[0]), 0, (int32_t)g_ui32PWMPeriod - 1);
+    PidSetSetpoint(&g_sLightPid, LIGHT_SETPOINT);
 		SetupLEDs();
+    SetupADC();     // A malha de controle comeca a rodar aqui
 
     while (1) {
         if (g_bNewLDRValue) {
             // Reseta a flag de novo valor do LDR
             g_bNewLDRValue = false;
+            uint32_t ui32Raw = g_ui32LDRRaw;
+
+            // Captura a leitura crua, antes do filtro; a gravacao do bloco para a CPU por
+            // alguns us (alguns ms quando apaga um setor). Pausa durante um dump, que le os
+            // registros direto da flash e nao pode ver um setor apagado no meio.
+            if (g_bCapture && !g_bDumping && !g_bErasing)
+                FlashLogBlockAdd(&g_sCaptureBlock, CAPTURE_TAG_LDR, (uint16_t)ui32Raw, g_ui32Millis);
 
-            // Processa o valor do LDR
+            // LEDs e telemetria com o valor filtrado; o PWM ja foi atualizado na ISR
             ProcessLDRValue(g_ui32LDRValue);
         }
+        // Um setor por passada: cada apagamento custa no maximo alguns periodos do controle.
+        // Nada apaga a flash sob o cursor de um "dump": o apagamento continua quando ele acaba.
+        if (g_bErasing && !g_bDumping && FlashLogEraseStep())
+            g_bErasing = false;
+        ProcessCommands();
+        DrainLog();
+        DumpCapture();
     }
 }
 
@@ -73,9 +159,9 @@ void SetupPWM(void) {
     SysCtlPWMClockSet(SYSCTL_PWMDIV_2); 
 
     // Configura gerador PWM
-    uint32_t pwmPeriod = (SysClock/1) / PWM_FREQUENCY;  // Adjust clock division here
+    g_ui32PWMPeriod = (SysClock/1) / PWM_FREQUENCY;  // Adjust clock division here
     PWMGenConfigure(PWM0_BASE, PWM_GEN_2, PWM_GEN_MODE_DOWN);
-    PWMGenPeriodSet(PWM0_BASE, PWM_GEN_2, pwmPeriod);
+    PWMGenPeriodSet(PWM0_BASE, PWM_GEN_2, g_ui32PWMPeriod);
     PWMPulseWidthSet(PWM0_BASE, PWM_OUT_5, g_ui32PWMDutyCycle);
     PWMOutputState(PWM0_BASE, PWM_OUT_5_BIT, true);
     PWMGenEnable(PWM0_BASE, PWM_GEN_2);
@@ -84,6 +170,135 @@ void SetupPWM(void) {
 void UARTIntHandler(void) {
     uint32_t status = UARTIntStatus(UART0_BASE, true);
     UARTIntClear(UART0_BASE, status);
+    UartTxIntHandler();
+    UartRxIntHandler();
+}
+
+// "ldr": ultima leitura e duty cycle
+void CmdLdr(const CmdToken *args, uint32_t count, void *context) {
+    DLOG2(LOG_LDR_STATUS, g_ui32LDRValue, g_ui32PWMDutyCycle);
+}
+
+// "quiet" / "verbose": liga e desliga a impressao de cada leitura
+void CmdQuiet(const CmdToken *args, uint32_t count, void *context) {
+    g_bVerbose = false;
+}
+
+void CmdVerbose(const CmdToken *args, uint32_t count, void *context) {
+    g_bVerbose = true;
+}
+
+// "parser": custo do interpretador em ciclos por linha
+void CmdParserInfo(const CmdToken *args, uint32_t count, void *context) {
+    CmdParserStats stats;
+    CmdParserGetStats(&g_sCmdParser, &stats);
+    DLOG3(LOG_PARSER, stats.lines, stats.lines ? stats.cycles / stats.lines : 0, stats.maxCycles);
+}
+
+// "adc": amostras, perdas e jitter do periodo de aquisicao
+void CmdAdc(const CmdToken *args, uint32_t count, void *context) {
+    AdcAcqStats sStats;
+    AdcAcqGetStats(&sStats);
+    DLOG3(LOG_ADC, sStats.samples, sStats.overruns, sStats.maxPeriod - sStats.minPeriod);
+}
+
+// "filter": custo de cada estagio da cadeia do LDR desde o ultimo "filter". A cadeia roda na
+// ISR do ADC: a copia e o zeramento sao feitos com as interrupcoes desligadas.
+void CmdFilter(const CmdToken *args, uint32_t count, void *context) {
+    uint32_t pui32Cycles[FILTER_STAGES_MAX];
+    bool bEnabled = !IntMasterDisable();
+    for (uint32_t i = 0; i < g_sLDRFilter.count; i++)
+        pui32Cycles[i] = FilterStageCyclesPer100(&g_sLDRFilter, i);
+    FilterChainResetStats(&g_sLDRFilter);
+    if (bEnabled)
+        IntMasterEnable();
+    for (uint32_t i = 0; i < g_sLDRFilter.count; i++)
+        DLOG3(LOG_FILTER_STAGE, i, g_sLDRFilter.stages[i].type, pui32Cycles[i]);
+}
+
+// "telemetry": leituras oferecidas, amostras enviadas e envios so por silencio
+void CmdTelemetry(const CmdToken *args, uint32_t count, void *context) {
+    ChangeGateStats sStats;
+    ChangeGateGetStats(&g_sLDRGate, &sStats);
+    DLOG3(LOG_TELEMETRY, sStats.offered, sStats.published, sStats.heartbeats);
+}
+
+// "capture on|off": grava as leituras cruas no log em flash; sem argumento mostra o estado do log
+void CmdCapture(const CmdToken *args, uint32_t count, void *context) {
+    if (count > 0 && CmdTokenIs(&args[0], "on")) {
+        g_bCapture = true;
+    } else if (count > 0 && CmdTokenIs(&args[0], "off")) {
+        g_bCapture = false;
+        FlashLogBlockFlush(&g_sCaptureBlock, CAPTURE_TAG_LDR);
+    }
+    FlashLogStats sStats;
+    FlashLogGetStats(&sStats);
+    DLOG3(LOG_CAPTURE, sStats.records, sStats.usedBytes, sStats.erases);
+}
+
+// "dump": manda o log inteiro, do registro mais antigo ao mais novo, no canal de captura
+void CmdDump(const CmdToken *args, uint32_t count, void *context) {
+    FlashLogRewind(&g_sDumpCursor);
+    g_bDumping = true;
+}
+
+// "erase": para a captura e apaga o log, um setor por passada do laco principal (depois
+// de um dump em andamento)
+void CmdErase(const CmdToken *args, uint32_t count, void *context) {
+    g_bCapture = false;
+    g_sCaptureBlock.count = 0;
+    g_bErasing = true;
+}
+
+// "pid": setpoint, luz e duty atuais, a latencia da malha, as saturacoes e os periodos
+// perdidos desde o ultimo "pid"; "pid <luz>" muda o setpoint (0 a 4095, o PID troca de
+// faixa de ganhos na ISR)
+void CmdPid(const CmdToken *args, uint32_t count, void *context) {
+    static PidStats sLastStats;
+    if (count > 0 && args[0].type == CMD_TOKEN_NUMBER && args[0].value <= LDR_FULL_SCALE)
+        g_i32LightSetpoint = (int32_t)args[0].value;
+    bool bEnabled = !IntMasterDisable();
+    uint32_t ui32Sum = g_ui32LatencySum;
+    uint32_t ui32Count = g_ui32LatencyCount;
+    uint32_t ui32Max = g_ui32LatencyMax;
+    uint32_t ui32Compute = g_ui32ComputeMax;
+    uint32_t ui32Missed = g_ui32MissedPeriods;
+    PidStats sStats = g_sLightPid.stats;
+    g_ui32LatencySum = g_ui32LatencyCount = g_ui32LatencyMax = g_ui32ComputeMax = g_ui32MissedPeriods = 0;
+    if (bEnabled)
+        IntMasterEnable();
+    DLOG3(LOG_PID, g_i32LightSetpoint, LDR_FULL_SCALE - g_ui32LDRValue, g_ui32PWMDutyCycle);
+    DLOG3(LOG_PID_LATENCY, ui32Count ? ui32Sum / ui32Count : 0, ui32Max, ui32Compute);
+    DLOG3(LOG_PID_STATS, sStats.saturated - sLastStats.saturated, sStats.frozen - sLastStats.frozen, ui32Missed);
+    sLastStats = sStats;
+}
+
+void CmdInvalid(const CmdToken *args, uint32_t count, void *context) {
+    DLOG0(LOG_INVALID);
+}
+
+const CmdEntry g_psCommands[] = {
+    {"ldr", CmdLdr},
+    {"quiet", CmdQuiet},
+    {"verbose", CmdVerbose},
+    {"parser", CmdParserInfo},
+    {"adc", CmdAdc},
+    {"filter", CmdFilter},
+    {"telemetry", CmdTelemetry},
+    {"capture", CmdCapture},
+    {"dump", CmdDump},
+    {"erase", CmdErase},
+    {"pid", CmdPid},
+};
+
+// Interpreta as linhas ja recebidas direto do buffer de RX (chamada pelo laco principal)
+void ProcessCommands(void) {
+    const char *data;
+    uint32_t length;
+    while ((length = UartRxPeek(&data)) > 0) {
+        CmdParserFeed(&g_sCmdParser, data, length);
+        UartRxConsume(length);
+    }
 }
 
 void SetupUart(void) {
@@ -101,7 +316,10 @@ void SetupUart(void) {
 		    // 115200, 8-N-1 
     UARTConfigSetExpClk(UART0_BASE, SysClock, 115200,
                         (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
-    UARTIntEnable(UART0_BASE, UART_INT_RX | UART_INT_RT);
+    CmdParserInit(&g_sCmdParser, g_psCommands, sizeof(g_psCommands) / sizeof(g_psCommands[0]), CmdInvalid, NULL, 0);
+    UartTxInit(UART0_BASE, INT_UART0);
+    UartRxInit(UART0_BASE, NULL);
+    UARTIntRegister(UART0_BASE, UARTIntHandler);
 	
 		// Configure GPIO pins for UART0
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
@@ -132,81 +350,114 @@ void SetupLEDs(void) {
 }
 
 
+// O Timer0 dispara o ADC por hardware a cada 10 ms; nenhuma ISR espera a conversao
 void SetupADC(void) {
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
-    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_ADC0));
-
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
-    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOE));
-
-    GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_3);
-
-    ADCSequenceConfigure(ADC0_BASE, ADC_SEQUENCER, ADC_TRIGGER_PROCESSOR, 0);
-    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQUENCER, 0, ADC_CTL_CH0 | ADC_CTL_IE | ADC_CTL_END);
-    ADCSequenceEnable(ADC0_BASE, ADC_SEQUENCER);
-    ADCIntClear(ADC0_BASE, ADC_SEQUENCER);
+    g_ui32SamplePeriod = SysClock / ADC_RATE_HZ;
+    AdcAcqInit(SysClock, ADC_RATE_HZ, ADC_OVERSAMPLE, LDRSampleReady);
+    AdcAcqStart();
 }
 
-void SetupTimer(void) {
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
-    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER0));
-    TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
-    TimerLoadSet(TIMER0_BASE, TIMER_A, SysClock / 100); // 10ms
-    TimerIntEnable(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
-    TimerIntRegister(TIMER0_BASE, TIMER_A, Timer0IntHandler);
-    TimerEnable(TIMER0_BASE, TIMER_A);
+// Chamada pela ISR do ADC com a media das conversoes: a malha de controle inteira roda aqui,
+// a 100 Hz cravados pelo Timer0, sem depender do laco principal. O novo duty vale a partir
+// do proximo periodo do PWM. Enquanto a flash apaga um setor a ISR nao roda; os periodos
+// que passaram sem ela entram em g_ui32MissedPeriods (e no relogio em ms).
+void LDRSampleReady(uint32_t ui32Sample) {
+    uint32_t ui32Start = TimingNow();
+    uint32_t ui32Periods = 1;
+    if (g_bSamplePrimed)
+        ui32Periods = (ui32Start - g_ui32LastSample + g_ui32SamplePeriod / 2) / g_ui32SamplePeriod;
+    if (ui32Periods > 1)
+        g_ui32MissedPeriods += ui32Periods - 1;
+    else
+        ui32Periods = 1;
+    g_ui32LastSample = ui32Start;
+    g_bSamplePrimed = true;
+    g_ui32Millis += ui32Periods * (1000 / ADC_RATE_HZ);
+    uint32_t ui32Filtered = FilterLDR(ui32Sample);
+
+    if (g_i32LightSetpoint != g_sLightPid.setpoint)
+        PidSetSetpoint(&g_sLightPid, g_i32LightSetpoint);
+    uint32_t ui32Duty = (uint32_t)PidUpdate(&g_sLightPid, LDR_FULL_SCALE - (int32_t)ui32Filtered);
+    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_5, ui32Duty);
+
+    uint32_t ui32Latency = AdcAcqSampleAge();
+    uint32_t ui32Compute = TimingNow() - ui32Start;
+    g_ui32LatencySum += ui32Latency;
+    g_ui32LatencyCount++;
+    if (ui32Latency > g_ui32LatencyMax)
+        g_ui32LatencyMax = ui32Latency;
+    if (ui32Compute > g_ui32ComputeMax)
+        g_ui32ComputeMax = ui32Compute;
+
+    g_ui32PWMDutyCycle = ui32Duty;
+    g_ui32LDRRaw = ui32Sample;
+    g_ui32LDRValue = ui32Filtered;
+    g_bNewLDRValue = true; // Sinaliza que há um novo valor disponível
 }
 
-void Timer0IntHandler(void) {
-    TimerIntClear(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
-
-    uint32_t adcValue;
-    ADCProcessorTrigger(ADC0_BASE, ADC_SEQUENCER);
-    while (!ADCIntStatus(ADC0_BASE, ADC_SEQUENCER, false));
-    ADCIntClear(ADC0_BASE, ADC_SEQUENCER);
-    ADCSequenceDataGet(ADC0_BASE, ADC_SEQUENCER, &adcValue);
-
-    g_ui32LDRValue = adcValue;
-    g_bNewLDRValue = true; // Sinaliza que há um novo valor disponível
+// Uma amostra pela cadeia: mediana e EMA em Q15
+uint32_t FilterLDR(uint32_t ui32Value) {
+    int16_t i16Sample = FILTER_Q15_FROM_ADC(ui32Value);
+    FilterChainProcess(&g_sLDRFilter, &i16Sample, 1);
+    return FILTER_ADC_FROM_Q15(i16Sample);
 }
 
 void ProcessLDRValue(uint32_t ldrValue) {
-		uint32_t pwmPeriod = PWMGenPeriodGet(PWM0_BASE, PWM_GEN_2);	  
+		// Os LEDs mostram em que quarto da faixa esta o duty escolhido pelo PID
+		uint32_t ui32Duty = g_ui32PWMDutyCycle;
+		uint32_t ui32Step = (ui32Duty * 4) / g_ui32PWMPeriod;
 
-    if (ldrValue < 3000) {
+    if (ui32Step == 0) {
 				GPIOPinWrite(LED_PORTN, LED1, LED1);
 				GPIOPinWrite(LED_PORTN, LED2, 0);
 				GPIOPinWrite(LED_PORTF, LED3 | LED4, 0);
-        g_ui32PWMDutyCycle = 0;
-    } else if (ldrValue < 3500) {
+    } else if (ui32Step == 1) {
 				GPIOPinWrite(LED_PORTN, LED1, 0);
 				GPIOPinWrite(LED_PORTN, LED2, LED2);
 				GPIOPinWrite(LED_PORTF, LED3 | LED4, 0);
-        g_ui32PWMDutyCycle = (pwmPeriod * 25) / 100;
-    } else if (ldrValue < 4000) {
+    } else if (ui32Step == 2) {
 				GPIOPinWrite(LED_PORTN, LED1 | LED2, 0);
 				GPIOPinWrite(LED_PORTF, LED3, LED3);
 				GPIOPinWrite(LED_PORTF, LED4, 0);
-        g_ui32PWMDutyCycle = (pwmPeriod * 50) / 100;
     } else {
 				GPIOPinWrite(LED_PORTN, LED1 | LED2, 0);
 				GPIOPinWrite(LED_PORTF, LED3, 0);
 				GPIOPinWrite(LED_PORTF, LED4, LED4);
-        g_ui32PWMDutyCycle = (pwmPeriod * 75) / 100;
     }
 		
-		char buffer[50];
-		sprintf(buffer, "LDR Value: %u\r\n", g_ui32LDRValue);
-		UARTSend(buffer);
-		
-		sprintf(buffer, "Duty cycle: %u\r\n", g_ui32PWMDutyCycle);
-		UARTSend(buffer);
+		// So manda telemetria quando a leitura sai da faixa morta, o duty muda de quarto ou passa
+		// LDR_MAX_SILENCE_MS sem envio (o PID mexe no duty a cada amostra). A troca de quarto
+		// forca o envio, mas sempre com LDR_MIN_INTERVAL_MS entre amostras.
+		bool bStepChanged = ui32Step != g_ui32SentStep;
+		if (g_bVerbose && (bStepChanged ? ChangeGateForce(&g_sLDRGate, (int32_t)ldrValue, g_ui32Millis)
+		                                : ChangeGateOffer(&g_sLDRGate, (int32_t)ldrValue, g_ui32Millis))) {
+			// Registro binario no canal de telemetria; se o buffer de TX estiver cheio a amostra e descartada
+			tLDRSample sSample = {TimingNow(), (uint16_t)ldrValue, (uint16_t)ui32Duty};
+			LinkSend(LINK_CH_TELEMETRY, &sSample, sizeof(sSample));
+			g_ui32SentStep = ui32Step;
+		}
+}
 
-    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_5, g_ui32PWMDutyCycle);
+// Passa os registros do log adiado para o canal de logs da UART; um registro so sai do
+// log quando o quadro cabe inteiro (chamada pelo laco principal)
+void DrainLog(void) {
+    uint8_t pui8Record[DLOG_RECORD_MAX];
+    uint32_t ui32Length;
+    while (UartTxFree() >= LINK_FRAME_MAX(DLOG_RECORD_MAX) && (ui32Length = DlogEncodeNext(pui8Record)) > 0) {
+        LinkSend(LINK_CH_LOGS, pui8Record, ui32Length);
+    }
 }
 
-void UARTSend(const char *pui8Buffer) {
-    while (*pui8Buffer) {
-        UARTCharPut(UART0_BASE, *pui8Buffer++);
+// Manda os registros do log em flash enquanto couberem no buffer de TX, um quadro por
+// registro, lidos direto da flash; um quadro vazio marca o fim (chamada pelo laco principal)
+void DumpCapture(void) {
+    static uint8_t pui8Frame[LINK_FRAME_MAX(FLASH_LOG_RECORD_MAX)];
+    const uint8_t *pui8Record = NULL;
+    uint32_t ui32Length;
+    while (g_bDumping && UartTxFree() >= sizeof(pui8Frame)) {
+        ui32Length = FlashLogNext(&g_sDumpCursor, &pui8Record);
+        if (ui32Length == 0)
+            g_bDumping = false;
+        UartTxWrite((const char *)pui8Frame, LinkEncode(LINK_CH_CAPTURE, pui8Record, ui32Length, pui8Frame));
     }
 }
@@ -0,0 +1,24 @@
+#ifndef LOG_FORMATS_H
+#define LOG_FORMATS_H
+
+#include "dlog.h"
+
+// Mensagens do Lab4. A ordem define o ID gravado no quadro: o decodificador do host
+// (host/link_cat.cpp) e compilado com este mesmo arquivo, entao so acrescente no final.
+#define LOG_FORMATS(X) \
+    X(LOG_LDR_VALUE,        "LDR Value: %u\r\n") \
+    X(LOG_AVERAGE,          "Media: %u\r\n") \
+    X(LOG_AVERAGE_QUEUE,    "Fila de medias: %u substituidas, pico %u\r\n") \
+    X(LOG_STREAM,           "Leitura: min %u max %u, %u blocos/amostras perdidos\r\n") \
+    X(LOG_BENCH_MUTEX,      "Mutex: publicacao media %u max %u ciclos, %u leituras\r\n") \
+    X(LOG_BENCH_SEQLOCK,    "Seqlock: publicacao media %u max %u ciclos, %u leituras\r\n") \
+    X(LOG_BENCH_RETRIES,    "Seqlock: %u releituras em %u publicacoes\r\n") \
+    X(LOG_FILTER_STAGE,     "Filtro %u (tipo %u): %u ciclos por 100 amostras\r\n") \
+    X(LOG_REPORTS,          "Leituras: %u, enviadas %u, %u por silencio\r\n") \
+    X(LOG_CAPTURE,          "Captura: %u registros gravados, %u bytes em uso, %u setores apagados\r\n") \
+    X(LOG_INVALID,          "Comando invalido\r\n") \
+    X(LOG_WINDOW,           "Janela da media: %u leituras\r\n")
+
+enum { LOG_FORMATS(DLOG_ENUM) LOG_COUNT };
+
+#endif // LOG_FORMATS_H
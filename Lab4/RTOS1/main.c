@@ -1,36 +1,104 @@
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
+#include <stddef.h>
 #include "cmsis_os2.h"
 #include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/gpio.h"
 #include "driverlib/uart.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/interrupt.h"
-#include "driverlib/adc.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "cmd_parser.h"
+#include "timing.h"
+#include "dlog.h"
+#include "link.h"
+#include "msg_queue.h"
+#include "adc_stream.h"
+#include "window_stats.h"
+#include "seqlock.h"
+#include "filter.h"
+#include "change_gate.h"
+#include "flash_log.h"
+#include "log_formats.h"
 
 // Definies para o ADC e sensor
-#define ADC_SEQUENCER     3         // Sequenciador do ADC para uma nica amostra
+#define STREAM_RATE_HZ    20000     // Amostras por segundo, disparadas pelo Timer0
+#define STREAM_BLOCK      500       // Amostras por bloco do uDMA (25 ms)
+#define BLOCKS_PER_READING 20       // Blocos somados em cada leitura (0,5 s)
+
+// Cadeia de filtros sobre cada bloco: mediana de 5 tira picos isolados, media de 8 e um
+// Butterworth de 2a ordem em 500 Hz (coeficientes Q14, b1 ajustado para ganho DC 1)
+#define FILTER_LOG_READINGS 10      // Custo de cada estagio no log a cada 5 s
+static const int16_t boxcar8[8] = {4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096};
+static const int16_t lowpass500[5] = {91, 181, 91, -29141, 13120};
+FilterChain sensorFilter;
+int16_t filterBlock[STREAM_BLOCK];  // Copia do bloco em Q15; libera o buffer do uDMA cedo
+
+// Leituras e medias so vao para o log quando mudam (o tick do RTX e de 1 ms); sem mudanca,
+// uma de cada a cada 10 s
+#define READING_DEADBAND  10        // Contagens do ADC
+#define AVERAGE_DEADBAND_PERMILLE 5 // 0,5% da ultima media enviada
+#define REPORT_SILENCE_MS 10000
+ChangeGate readingGate;             // So Thread_ReadSensor
+ChangeGate averageGate;             // So Thread_UARTWrite
+
+// Captura em flash: uma de cada CAPTURE_DECIMATE amostras filtradas (2 kHz, ~15 s no log).
+// So Thread_ReadSensor grava ou apaga o log; os comandos so deixam pedidos. Enquanto um dump
+// le a flash (Thread_LogDrain) a captura e o apagamento ficam parados: como Thread_ReadSensor
+// tem prioridade maior, quando o dump roda nenhuma gravacao esta pela metade.
+#define CAPTURE_DECIMATE  10
+#define CAPTURE_TAG_FILTERED 2
+FlashLogBlock captureBlock;
+volatile bool captureOn;            // "capture on|off"
+volatile bool captureErase;         // "erase", feito um setor por bloco
+volatile bool dumpActive;           // De "dump" ate o ultimo quadro do Thread_LogDrain
+
+#define RX_FLAG_DATA      0x0001    // Thread_Command, avisada pela ISR da UART
+osThreadId_t commandThreadId;
+CmdParser commandParser;
 
 // Definies para o clculo da mdia
-#define NUM_READINGS      10        // Nmero de leituras para mdia
-volatile uint32_t sensorReadings[NUM_READINGS] = {0}; // Vetor para armazenar as ltimas 10 leituras
-volatile uint8_t readingIndex = 0;                   // ndice corrente para o vetor de leituras
+#define NUM_READINGS      10        // Leituras na media movel no boot ("window <n>" muda ate WINDOW_STATS_MAX)
+WindowStats sensorWindow;           // Ultimas leituras com a soma corrente (so Thread_ReadSensor mexe)
+volatile uint32_t windowRequest;    // Tamanho pedido por "window <n>" (0 = nenhum), aplicado por Thread_ReadSensor
+Seqlock sensorPublish;              // Copia publicada de sensorWindow para as outras threads
+WindowSnapshot sensorCopies[2];
+
+// Benchmark de boot: mutex contra seqlock com leitores disputando a mesma copia
+#define BENCH_READERS     2
+#define BENCH_DURATION_MS 250       // Por modo; o escritor publica a cada 1 ms
 
 // Objetos do RTOS
-osMutexId_t sensorMutex;                // Mutex para acesso ao vetor sensorReadings
-osMessageQueueId_t queueAverageResult;  // Fila para enviar o valor mdio para a thread de UART
+MsgQueue queueBlocks;                   // Blocos cheios da ISR do uDMA para a thread de leitura
+MsgQueue queueAverageResult;            // Fila para enviar o valor mdio para a thread de UART
 
 uint32_t SysClock;  // Frequncia do sistema
 
+// A ISR so move bytes: o buffer de TX para a FIFO e a FIFO de RX para o buffer de RX
+void UARTIntHandler(void) {
+    uint32_t status = UARTIntStatus(UART0_BASE, true);
+    UARTIntClear(UART0_BASE, status);
+    UartTxIntHandler();
+    UartRxIntHandler();
+}
+
+static void UartRxLineReady(void) {
+    if (commandThreadId != NULL)
+        osThreadFlagsSet(commandThreadId, RX_FLAG_DATA);
+}
+
 // Configurao da UART (mesma de antes)
 void SetupUart(void) {
     SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
     while(!SysCtlPeripheralReady(SYSCTL_PERIPH_UART0));
     UARTConfigSetExpClk(UART0_BASE, SysClock, 115200,
         (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
-    UARTFIFODisable(UART0_BASE);
+    UartTxInit(UART0_BASE, INT_UART0);
+    UartRxInit(UART0_BASE, UartRxLineReady);
+    UARTIntRegister(UART0_BASE, UARTIntHandler);
     // Configurao dos pinos
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
     while(!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOA));
@@ -39,72 +107,208 @@ void SetupUart(void) {
     GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
 }
 
-void UARTSend(const char *pui8Buffer) {
-    while (*pui8Buffer) {
-        UARTCharPut(UART0_BASE, *pui8Buffer++);
+// Thread 4: Esvazia o log adiado no canal de logs da UART. E o unico produtor do buffer de TX;
+// as outras threads so gravam registros (ID + argumentos) e o host monta o texto (host/link_cat.cpp).
+// Durante um "dump" tambem manda o log em flash, um quadro por registro lido direto da flash,
+// com o que sobrar do buffer de TX; um quadro vazio marca o fim.
+void Thread_LogDrain(void *argument) {
+    (void) argument;
+    static uint8_t frame[LINK_FRAME_MAX(FLASH_LOG_RECORD_MAX)];
+    uint8_t record[DLOG_RECORD_MAX];
+    uint32_t length;
+    FlashLogCursor cursor;
+    bool dumping = false;
+    while (true) {
+        while (UartTxFree() >= LINK_FRAME_MAX(DLOG_RECORD_MAX) && (length = DlogEncodeNext(record)) > 0) {
+            LinkSend(LINK_CH_LOGS, record, length);
+        }
+        if (dumpActive && !dumping) {
+            FlashLogRewind(&cursor);
+            dumping = true;
+        }
+        while (dumping && UartTxFree() >= sizeof(frame)) {
+            const uint8_t *stored = NULL;
+            length = FlashLogNext(&cursor, &stored);
+            if (length == 0)
+                dumping = dumpActive = false;   // A captura volta no proximo bloco
+            UartTxWrite((const char *)frame, LinkEncode(LINK_CH_CAPTURE, stored, length, frame));
+        }
+        osDelay(10);
+    }
+}
+
+// "capture on|off": grava as amostras filtradas no log em flash; sem argumento mostra o estado
+void CmdCapture(const CmdToken *args, uint32_t count, void *context) {
+    if (count > 0 && CmdTokenIs(&args[0], "on"))
+        captureOn = true;
+    else if (count > 0 && CmdTokenIs(&args[0], "off"))
+        captureOn = false;
+    FlashLogStats stats;
+    FlashLogGetStats(&stats);
+    DLOG3(LOG_CAPTURE, stats.records, stats.usedBytes, stats.erases);
+}
+
+// "dump": manda o log inteiro, do registro mais antigo ao mais novo; a captura pausa ate o fim
+void CmdDump(const CmdToken *args, uint32_t count, void *context) {
+    dumpActive = true;
+}
+
+// "erase": para a captura e apaga o log nos proximos blocos (depois de um dump em andamento)
+void CmdErase(const CmdToken *args, uint32_t count, void *context) {
+    captureOn = false;
+    captureErase = true;
+}
+
+// "window <n>": muda o tamanho da media movel (1 a WINDOW_STATS_MAX) na proxima leitura;
+// sem argumento mostra o tamanho atual
+void CmdWindow(const CmdToken *args, uint32_t count, void *context) {
+    if (count == 0) {
+        WindowSnapshot snapshot;
+        SeqlockRead(&sensorPublish, &snapshot);
+        DLOG1(LOG_WINDOW, snapshot.length);
+    } else if (args[0].type == CMD_TOKEN_NUMBER && args[0].value >= 1 && args[0].value <= WINDOW_STATS_MAX) {
+        windowRequest = args[0].value;
+    } else {
+        DLOG0(LOG_INVALID);
     }
 }
 
-// Configurao do ADC (conforme o cdigo original)
-void SetupADC(void) {
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
-    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_ADC0));
+void CmdInvalid(const CmdToken *args, uint32_t count, void *context) {
+    DLOG0(LOG_INVALID);
+}
+
+const CmdEntry commands[] = {
+    {"capture", CmdCapture},
+    {"dump", CmdDump},
+    {"erase", CmdErase},
+    {"window", CmdWindow},
+};
 
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
-    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOE));
+// Thread 5: Interpreta as linhas recebidas direto do buffer de RX
+void Thread_Command(void *argument) {
+    (void) argument;
+    CmdParserInit(&commandParser, commands, sizeof(commands) / sizeof(commands[0]), CmdInvalid, NULL, 0);
+    while (true) {
+        const char *data;
+        uint32_t length;
+        osThreadFlagsWait(RX_FLAG_DATA, osFlagsWaitAny, osWaitForever);
+        while ((length = UartRxPeek(&data)) > 0) {
+            CmdParserFeed(&commandParser, data, length);
+            UartRxConsume(length);
+        }
+    }
+}
 
-    // Configura o pino para entrada analgica (no exemplo, PE3)
-    GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_3);
+// Grava um bloco filtrado no log em flash. Cada registro para a CPU por alguns us; apagar um
+// setor leva alguns ms, entao cada bloco apaga no maximo um (na troca de setor da captura ou
+// um passo do "erase"), dentro dos 50 ms de folga dos dois blocos do uDMA.
+static void CaptureBlock(const uint16_t *filtered) {
+    if (dumpActive)
+        return;     // O dump le direto da flash: as amostras deste bloco nao entram no log
+    if (captureErase) {
+        captureBlock.count = 0;
+        if (FlashLogEraseStep())
+            captureErase = false;
+        return;
+    }
+    if (captureOn) {
+        uint32_t now = osKernelGetTickCount();
+        for (uint32_t i = 0; i < STREAM_BLOCK; i += CAPTURE_DECIMATE)
+            FlashLogBlockAdd(&captureBlock, CAPTURE_TAG_FILTERED, filtered[i], now);
+    } else if (captureBlock.count > 0) {
+        FlashLogBlockFlush(&captureBlock, CAPTURE_TAG_FILTERED);
+    }
+}
 
-    ADCSequenceConfigure(ADC0_BASE, ADC_SEQUENCER, ADC_TRIGGER_PROCESSOR, 0);
-    ADCSequenceStepConfigure(ADC0_BASE, ADC_SEQUENCER, 0,
-                             ADC_CTL_CH0 | ADC_CTL_IE | ADC_CTL_END);
-    ADCSequenceEnable(ADC0_BASE, ADC_SEQUENCER);
-    ADCIntClear(ADC0_BASE, ADC_SEQUENCER);
+// Chamada pela ISR do ADC quando o uDMA fecha um bloco: so enfileira o ponteiro.
+// Ha dois blocos, entao a fila nunca tem mais que dois.
+void BlockReady(const uint16_t *block, uint32_t count) {
+    (void) count;
+    MsgQueuePut(&queueBlocks, &block, 0);
 }
 
-// Thread 1: Leitura do sensor a cada 0,5 s
+// Thread 1: Acorda uma vez por bloco; a cada BLOCKS_PER_READING blocos (0,5 s) grava a media
 void Thread_ReadSensor(void *argument) {
     (void) argument;
+    uint32_t blocks = 0;
+    uint32_t readings = 0;
+    uint32_t reportedLost = 0;
+    uint32_t sum = 0;
+    uint16_t min = UINT16_MAX;
+    uint16_t max = 0;
     while (true) {
-        // Inicia a converso ADC
-        ADCProcessorTrigger(ADC0_BASE, ADC_SEQUENCER);
-        // Aguarda a concluso da converso
-        while(!ADCIntStatus(ADC0_BASE, ADC_SEQUENCER, false));
-        ADCIntClear(ADC0_BASE, ADC_SEQUENCER);
-        uint32_t sensorValue = 0;
-        ADCSequenceDataGet(ADC0_BASE, ADC_SEQUENCER, &sensorValue);
-
-        // Armazena a leitura no vetor com proteo do mutex
-        osMutexAcquire(sensorMutex, osWaitForever);
-        sensorReadings[readingIndex] = sensorValue;
-        readingIndex = (readingIndex + 1) % NUM_READINGS;
-        osMutexRelease(sensorMutex);
-
-        osDelay(500);  // Delay de 500 ms
+        const uint16_t *block;
+        if (MsgQueueGet(&queueBlocks, &block, osWaitForever) != osOK)
+            continue;
+        for (uint32_t i = 0; i < STREAM_BLOCK; i++)
+            filterBlock[i] = FILTER_Q15_FROM_ADC(block[i]);
+        AdcStreamRelease(block);    // O uDMA pode voltar a escrever nele
+
+        // Filtra no lugar e volta para a escala do ADC antes de resumir
+        FilterChainProcess(&sensorFilter, filterBlock, STREAM_BLOCK);
+        uint16_t *filtered = (uint16_t *)filterBlock;
+        for (uint32_t i = 0; i < STREAM_BLOCK; i++)
+            filtered[i] = FILTER_ADC_FROM_Q15(filterBlock[i]);
+        CaptureBlock(filtered);
+        AdcBlockSummary summary;
+        AdcStreamSummarize(filtered, STREAM_BLOCK, &summary);
+
+        sum += summary.sum;
+        if (summary.min < min)
+            min = summary.min;
+        if (summary.max > max)
+            max = summary.max;
+        if (++blocks < BLOCKS_PER_READING)
+            continue;
+
+        // Atualiza a janela (O(1)) e publica a copia; nunca espera pelos leitores
+        uint32_t reading = sum / (STREAM_BLOCK * BLOCKS_PER_READING);
+        uint32_t length = windowRequest;
+        if (length != 0) {
+            windowRequest = 0;
+            WindowStatsSetLength(&sensorWindow, length);   // O(N), so na troca
+            DLOG1(LOG_WINDOW, length);
+        }
+        WindowSnapshot snapshot;
+        WindowStatsPush(&sensorWindow, reading);
+        WindowStatsSnapshot(&sensorWindow, &snapshot);
+        SeqlockPublish(&sensorPublish, &snapshot);
+        AdcStreamStats stats;
+        AdcStreamGetStats(&stats);
+        uint32_t lost = stats.overruns + stats.fifoOverflows;
+        bool report = ChangeGateOffer(&readingGate, (int32_t)reading, osKernelGetTickCount());
+        if (report)
+            DLOG1(LOG_LDR_VALUE, reading);
+        if (report || lost != reportedLost) {
+            DLOG3(LOG_STREAM, min, max, lost);
+            reportedLost = lost;
+        }
+        if (++readings == FILTER_LOG_READINGS) {
+            for (uint32_t i = 0; i < sensorFilter.count; i++)
+                DLOG3(LOG_FILTER_STAGE, i, sensorFilter.stages[i].type, FilterStageCyclesPer100(&sensorFilter, i));
+            FilterChainResetStats(&sensorFilter);
+            ChangeGateStats gateStats;
+            ChangeGateGetStats(&readingGate, &gateStats);
+            DLOG3(LOG_REPORTS, gateStats.offered, gateStats.published, gateStats.heartbeats);
+            readings = 0;
+        }
+        blocks = sum = 0;
+        min = UINT16_MAX;
+        max = 0;
     }
 }
 
-// Thread 2: Calcula a mdia dos 10 ltimos valores
+// Thread 2: Calcula a mdia das NUM_READINGS ltimas leituras
 void Thread_Average(void *argument) {
     (void) argument;
     while (true) {
-        uint32_t sum = 0;
-        // Acesso protegido s leituras
-        osMutexAcquire(sensorMutex, osWaitForever);
-				char buffer[50];
-        for (uint8_t i = 0; i < NUM_READINGS; i++) {
-						
-						sprintf(buffer, "LDR Value: %u\r\n", sensorReadings[i]);
-						UARTSend(buffer);
-					
-            sum += sensorReadings[i];
-        }
-        osMutexRelease(sensorMutex);
-        uint32_t average = sum / NUM_READINGS;
+        // Copia consistente da janela sem trava; a media e o log vem depois
+        WindowSnapshot snapshot;
+        SeqlockRead(&sensorPublish, &snapshot);
+        uint32_t average = WindowSnapshotMean(&snapshot);
 
         // Envia a mdia para a fila que a thread de UART ir imprimir
-        osMessageQueuePut(queueAverageResult, &average, 0, 0);
+        MsgQueuePut(&queueAverageResult, &average, 0);
 
         osDelay(500);  
     }
@@ -114,17 +318,109 @@ void Thread_Average(void *argument) {
 void Thread_UARTWrite(void *argument) {
     (void) argument;
     uint32_t average;
+    uint32_t drops = 0;
     while (true) {
         // Espera pela mdia na fila (bloqueia at receber)
-        if (osMessageQueueGet(queueAverageResult, &average, NULL, osWaitForever) == osOK) {
-            char buffer[50];
-            snprintf(buffer, sizeof(buffer), "Media: %u\r\n", average);
-            // Envia a string para a UART caractere a caractere
-            for (char *p = buffer; *p; p++) {
-                while (!UARTCharPutNonBlocking(UART0_BASE, *p));
-            }
+        if (MsgQueueGet(&queueAverageResult, &average, osWaitForever) == osOK &&
+            ChangeGateOffer(&averageGate, (int32_t)average, osKernelGetTickCount())) {
+            DLOG1(LOG_AVERAGE, average);
+        }
+        MsgQueueStats stats;
+        MsgQueueGetStats(&queueAverageResult, &stats);
+        if (stats.drops != drops) {
+            drops = stats.drops;
+            DLOG2(LOG_AVERAGE_QUEUE, stats.drops, stats.highWater);
+        }
+    }
+}
+
+// Estado do benchmark de publicacao; benchMutex e benchShared reproduzem a versao com mutex
+static volatile bool benchRunning;
+static bool benchUseMutex;
+static osMutexId_t benchMutex;
+static WindowSnapshot benchShared;
+static Seqlock benchLock;
+static WindowSnapshot benchCopies[2];
+static volatile uint32_t benchReads[BENCH_READERS];
+
+// Leitor do benchmark: copia o valor publicado o mais rapido que puder
+void Thread_BenchReader(void *argument) {
+    uint32_t reader = (uint32_t)(uintptr_t)argument;
+    while (benchRunning) {
+        WindowSnapshot snapshot;
+        if (benchUseMutex) {
+            osMutexAcquire(benchMutex, osWaitForever);
+            snapshot = benchShared;
+            osMutexRelease(benchMutex);
+        } else {
+            SeqlockRead(&benchLock, &snapshot);
         }
+        benchReads[reader]++;
+        osThreadYield();
     }
+    osThreadExit();
+}
+
+// Um modo do benchmark: esta thread e o escritor (prioridade acima dos leitores, como a
+// thread de leitura do sensor) e mede os ciclos de cada publicacao
+static void RunPublishBench(bool useMutex, uint32_t *meanCycles, uint32_t *maxCycles, uint32_t *reads) {
+    const osThreadAttr_t readerAttr = {.name = "BenchReader", .priority = osPriorityBelowNormal, .stack_size = 512};
+    WindowStats window;
+    uint32_t publishes = 0;
+    uint64_t total = 0;
+
+    WindowStatsInit(&window, NUM_READINGS);
+    benchUseMutex = useMutex;
+    benchRunning = true;
+    for (uint32_t i = 0; i < BENCH_READERS; i++) {
+        benchReads[i] = 0;
+        osThreadNew(Thread_BenchReader, (void *)(uintptr_t)i, &readerAttr);
+    }
+    *maxCycles = 0;
+    for (uint32_t ms = 0; ms < BENCH_DURATION_MS; ms++) {
+        osDelay(1);
+        WindowSnapshot snapshot;
+        WindowStatsPush(&window, ms);
+        WindowStatsSnapshot(&window, &snapshot);
+
+        uint32_t start = TimingNow();
+        if (useMutex) {
+            osMutexAcquire(benchMutex, osWaitForever);
+            benchShared = snapshot;
+            osMutexRelease(benchMutex);
+        } else {
+            SeqlockPublish(&benchLock, &snapshot);
+        }
+        uint32_t cycles = TimingNow() - start;
+        total += cycles;
+        publishes++;
+        if (cycles > *maxCycles)
+            *maxCycles = cycles;
+    }
+    benchRunning = false;
+    osDelay(5);     // Os leitores saem no proximo giro
+
+    *meanCycles = (uint32_t)(total / publishes);
+    *reads = 0;
+    for (uint32_t i = 0; i < BENCH_READERS; i++)
+        *reads += benchReads[i];
+}
+
+// Roda uma vez no boot e termina; o resultado sai pelo log
+void Thread_PublishBench(void *argument) {
+    (void) argument;
+    uint32_t mean, max, reads;
+    benchMutex = osMutexNew(NULL);
+    SeqlockInit(&benchLock, benchCopies, sizeof(WindowSnapshot));
+
+    RunPublishBench(true, &mean, &max, &reads);
+    DLOG3(LOG_BENCH_MUTEX, mean, max, reads);
+    RunPublishBench(false, &mean, &max, &reads);
+    DLOG3(LOG_BENCH_SEQLOCK, mean, max, reads);
+    DLOG2(LOG_BENCH_RETRIES, benchLock.retries, benchLock.publishes);
+
+    osMutexDelete(benchMutex);
+    osThreadExit();
 }
 
 int main(void) {
@@ -133,21 +429,44 @@ int main(void) {
                                    SYSCTL_USE_PLL | SYSCTL_CFG_VCO_240),
                                    120000000);
     
+    TimingInit(SysClock);
+    FlashLogInit();
     SetupUart();
-    SetupADC();
 
     // Inicializa o kernel do RTOS
     osKernelInitialize();
 
-    // Cria o mutex para proteger o vetor de leituras
-    sensorMutex = osMutexNew(NULL);
+    // A janela e so da thread de leitura; as outras leem a copia publicada
+    WindowStatsInit(&sensorWindow, NUM_READINGS);
+    SeqlockInit(&sensorPublish, sensorCopies, sizeof(WindowSnapshot));
+    FilterChainInit(&sensorFilter);
+    FilterChainAddMedian(&sensorFilter, 5);
+    FilterChainAddFir(&sensorFilter, boxcar8, 8);
+    FilterChainAddBiquad(&sensorFilter, lowpass500);
+    const ChangeGateConfig readingConfig = {.absolute = READING_DEADBAND, .maxSilenceMs = REPORT_SILENCE_MS};
+    const ChangeGateConfig averageConfig = {.relativePermille = AVERAGE_DEADBAND_PERMILLE, .maxSilenceMs = REPORT_SILENCE_MS};
+    ChangeGateInit(&readingGate, &readingConfig);
+    ChangeGateInit(&averageGate, &averageConfig);
     // Cria a fila para enviar os valores mdios
-    queueAverageResult = osMessageQueueNew(10, sizeof(uint32_t), NULL);
+    // So a media mais recente interessa: se a thread de UART atrasar, a nova substitui a antiga.
+    // Assim nunca ha mais de uma esperando e uma posicao basta (eram 10, 160 bytes do RTX).
+    MsgQueueInit(&queueAverageResult, "Average", 1, sizeof(uint32_t), MSGQ_COALESCE_LATEST);
+    MsgQueueInit(&queueBlocks, "Blocks", 2, sizeof(const uint16_t *), MSGQ_DROP_OLDEST);
 
     // Cria as threads
     osThreadNew(Thread_ReadSensor, NULL, NULL);
     osThreadNew(Thread_Average, NULL, NULL);
     osThreadNew(Thread_UARTWrite, NULL, NULL);
+    const osThreadAttr_t drainAttr = {.name = "LogDrain", .priority = osPriorityLow};
+    osThreadNew(Thread_LogDrain, NULL, &drainAttr);
+    const osThreadAttr_t commandAttr = {.name = "Command", .priority = osPriorityAboveNormal, .stack_size = 1024};
+    commandThreadId = osThreadNew(Thread_Command, NULL, &commandAttr);
+    const osThreadAttr_t benchAttr = {.name = "PublishBench", .priority = osPriorityAboveNormal, .stack_size = 1024};
+    osThreadNew(Thread_PublishBench, NULL, &benchAttr);
+
+    // Primeiro bloco fecha 25 ms depois, com o kernel ja rodando
+    AdcStreamInit(SysClock, STREAM_RATE_HZ, STREAM_BLOCK, BlockReady);
+    AdcStreamStart();
 
     // Inicia o kernel do RTOS
     osKernelStart();
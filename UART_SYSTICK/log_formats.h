@@ -0,0 +1,22 @@
+#ifndef LOG_FORMATS_H
+#define LOG_FORMATS_H
+
+#include "dlog.h"
+
+// Mensagens do UART_SYSTICK. A ordem define o ID gravado no quadro: o decodificador do host
+// (host/link_cat.cpp) e compilado com este mesmo arquivo, entao so acrescente no final.
+#define LOG_FORMATS(X) \
+    X(LOG_LED_ON,           "LED %u LIGADO\r\n") \
+    X(LOG_SW_PRESSED,       "SW%u Pressionada\r\n") \
+    X(LOG_SW_RELEASED,      "SW%u Nao Pressionada\r\n") \
+    X(LOG_PARSER,           "Parser: %u comandos, media %u ciclos, pior %u ciclos\r\n") \
+    X(LOG_INVALID,          "Comando Invalido\r\n") \
+    X(LOG_TIME,             "Tempo: %u segundos\r\n") \
+    X(LOG_GAME_OVER,        "Fim de jogo!\r\n") \
+    X(LOG_SW1_DOWN,         "SW1 pressionado. Contagem iniciada.\r\n") \
+    X(LOG_SW1_UP,           "SW1 solto.\r\n") \
+    X(LOG_RESTART,          "Jogo reiniciado.\r\n")
+
+enum { LOG_FORMATS(DLOG_ENUM) LOG_COUNT };
+
+#endif // LOG_FORMATS_H
@@ -1,11 +1,20 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/gpio.h"
 #include "driverlib/uart.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/interrupt.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "cmd_parser.h"
+#include "timing.h"
+#include "dlog.h"
+#include "link.h"
+#include "log_formats.h"
 
 #define LED_PORTN GPIO_PORTN_BASE   // LEDs 1 e 2
 #define LED_PORTF GPIO_PORTF_BASE   // LEDs 3 e 4
@@ -24,60 +33,88 @@ volatile bool timeoutFlag = false;  // Flag para controle do timeout
 volatile uint32_t count = 0;   // Contador de tempo
 volatile bool sw1Pressed = false;  // Estado do SW1
 
-void UARTSendString(const char *str);
+CmdParser commandParser;  // Comandos de uma tecla recebidos pela UART
+
 void SwitchHandler(void);
 void SysTickHandler(void);  // Prottipo do SysTick Handler
 
 
 
-// Handler UART - Processa comandos via UART
+// Comandos '1' a '4': liga um LED e apaga os outros
+void CmdLed1(const CmdToken *args, uint32_t count, void *context) {
+    GPIOPinWrite(LED_PORTN, LED1, LED1);
+    GPIOPinWrite(LED_PORTN, LED2, 0);
+    GPIOPinWrite(LED_PORTF, LED3 | LED4, 0);
+    DLOG1(LOG_LED_ON, 1);
+}
+
+void CmdLed2(const CmdToken *args, uint32_t count, void *context) {
+    GPIOPinWrite(LED_PORTN, LED2, LED2);
+    GPIOPinWrite(LED_PORTN, LED1, 0);
+    GPIOPinWrite(LED_PORTF, LED3 | LED4, 0);
+    DLOG1(LOG_LED_ON, 2);
+}
+
+void CmdLed3(const CmdToken *args, uint32_t count, void *context) {
+    GPIOPinWrite(LED_PORTF, LED3, LED3);
+    GPIOPinWrite(LED_PORTN, LED1 | LED2, 0);
+    GPIOPinWrite(LED_PORTF, LED4, 0);
+    DLOG1(LOG_LED_ON, 3);
+}
+
+void CmdLed4(const CmdToken *args, uint32_t count, void *context) {
+    GPIOPinWrite(LED_PORTF, LED4, LED4);
+    GPIOPinWrite(LED_PORTN, LED1 | LED2, 0);
+    GPIOPinWrite(LED_PORTF, LED3, 0);
+    DLOG1(LOG_LED_ON, 4);
+}
+
+// Comandos '5' e '6': estado das chaves
+void CmdSw1(const CmdToken *args, uint32_t count, void *context) {
+    if (GPIOPinRead(SW_PORT, SW1) == 0) {
+        DLOG1(LOG_SW_PRESSED, 1);
+    } else {
+        DLOG1(LOG_SW_RELEASED, 1);
+    }
+}
+
+void CmdSw2(const CmdToken *args, uint32_t count, void *context) {
+    if (GPIOPinRead(SW_PORT, SW2) == 0) {
+        DLOG1(LOG_SW_PRESSED, 2);
+    } else {
+        DLOG1(LOG_SW_RELEASED, 2);
+    }
+}
+
+// Comando '7': custo do interpretador em ciclos por comando
+void CmdParserInfo(const CmdToken *args, uint32_t count, void *context) {
+    CmdParserStats stats;
+    CmdParserGetStats(&commandParser, &stats);
+    DLOG3(LOG_PARSER, stats.lines, stats.lines ? stats.cycles / stats.lines : 0, stats.maxCycles);
+}
+
+void CmdInvalid(const CmdToken *args, uint32_t count, void *context) {
+    DLOG0(LOG_INVALID);
+}
+
+const CmdEntry commands[] = {
+    {"1", CmdLed1}, {"2", CmdLed2}, {"3", CmdLed3}, {"4", CmdLed4},
+    {"5", CmdSw1}, {"6", CmdSw2}, {"7", CmdParserInfo},
+};
+
+// Handler UART - Reabastece a FIFO de TX e processa os comandos recebidos
 void UARTIntHandler(void) {
     uint32_t status = UARTIntStatus(UART0_BASE, true);
     UARTIntClear(UART0_BASE, status);
-    char command = (char)UARTCharGetNonBlocking(UART0_BASE);
-
-    switch (command) {
-        case '1':
-            GPIOPinWrite(LED_PORTN, LED1, LED1);
-						GPIOPinWrite(LED_PORTN, LED2, 0);
-						GPIOPinWrite(LED_PORTF, LED3 | LED4, 0);
-            UARTSendString("LED 1 LIGADO\r\n");
-            break;
-        case '2':
-            GPIOPinWrite(LED_PORTN, LED2, LED2);
-						GPIOPinWrite(LED_PORTN, LED1, 0);
-						GPIOPinWrite(LED_PORTF, LED3 | LED4, 0);
-            UARTSendString("LED 2 LIGADO\r\n");
-            break;
-        case '3':
-            GPIOPinWrite(LED_PORTF, LED3, LED3);
-						GPIOPinWrite(LED_PORTN, LED1 | LED2, 0);
-						GPIOPinWrite(LED_PORTF, LED4, 0);
-            UARTSendString("LED 3 LIGADO\r\n");
-            break;
-        case '4':
-            GPIOPinWrite(LED_PORTF, LED4, LED4);
-						GPIOPinWrite(LED_PORTN, LED1 | LED2, 0);
-						GPIOPinWrite(LED_PORTF, LED3, 0);
-            UARTSendString("LED 4 LIGADO\r\n");
-            break;
-				case '5':
-            if (GPIOPinRead(SW_PORT, SW1) == 0) {
-                UARTSendString("SW1 Pressionada\r\n");
-            } else {
-                UARTSendString("SW1 Nao Pressionada\r\n");
-            }
-            break;
-        case '6':
-            if (GPIOPinRead(SW_PORT, SW2) == 0) {
-                UARTSendString("SW2 Pressionada\r\n");
-            } else {
-                UARTSendString("SW2 Nao Pressionada\r\n");
-            }
-            break;
-        default:
-            UARTSendString("Comando Invalido\r\n");
-            break;
+    const char *data;
+    uint32_t length;
+    UartTxIntHandler();
+    UartRxIntHandler();
+
+    // Cada tecla e um comando; o interpretador le direto do buffer de RX
+    while ((length = UartRxPeek(&data)) > 0) {
+        CmdParserFeed(&commandParser, data, length);
+        UartRxConsume(length);
     }
 }
 
@@ -89,9 +126,7 @@ void SysTickHandler(void) {
 
         // Imprime tempo no Putty a cada 1 segundo
         if (count % 1000 == 0) {  // Considerando SysTick configurado para 1ms
-            char buffer[50];
-            snprintf(buffer, sizeof(buffer), "Tempo: %lu segundos\r\n", count / 1000);
-            UARTSendString(buffer);
+            DLOG1(LOG_TIME, count / 1000);  // So grava o registro; o main loop formata o quadro
         }
 
         if (count >= 10000) {  // Timeout de 10 segundos
@@ -103,7 +138,7 @@ void SysTickHandler(void) {
             GPIOPinWrite(LED_PORTN, LED1 | LED2, 0);
             GPIOPinWrite(LED_PORTF, LED3 | LED4, LED3 | LED4);
 
-            UARTSendString("Fim de jogo!\r\n");
+            DLOG0(LOG_GAME_OVER);
         }
     }
 }
@@ -133,10 +168,10 @@ void SwitchHandler(void) {
             GPIOPinWrite(LED_PORTN, LED1 | LED2, LED1 | LED2);
             GPIOPinWrite(LED_PORTF, LED3 | LED4, 0);
 
-            UARTSendString("SW1 pressionado. Contagem iniciada.\r\n");
+            DLOG0(LOG_SW1_DOWN);
         } else {
             sw1Pressed = false;  // Para a contagem
-            UARTSendString("SW1 solto.\r\n");
+            DLOG0(LOG_SW1_UP);
         }
     }
 
@@ -150,7 +185,7 @@ void SwitchHandler(void) {
         GPIOPinWrite(LED_PORTN, LED1 | LED2, LED1 | LED2);
         GPIOPinWrite(LED_PORTF, LED3 | LED4, LED3 | LED4);
 
-        UARTSendString("Jogo reiniciado.\r\n");
+        DLOG0(LOG_RESTART);
     }
 }
 
@@ -160,8 +195,8 @@ void SetupUart(void) {
     while (!SysCtlPeripheralReady(SYSCTL_PERIPH_UART0));
     UARTConfigSetExpClk(UART0_BASE, SysClock, 115200,
         (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
-    UARTFIFODisable(UART0_BASE);
-    UARTIntEnable(UART0_BASE, UART_INT_RX);
+    UartTxInit(UART0_BASE, INT_UART0);
+    UartRxInit(UART0_BASE, NULL);
     UARTIntRegister(UART0_BASE, UARTIntHandler);
 
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
@@ -192,10 +227,13 @@ void ConfigPeripherals(void) {
     GPIOIntEnable(SW_PORT, SW1 | SW2);
 }
 
-// Funo para enviar strings pela UART
-void UARTSendString(const char *str) {
-    while (*str != '\0') {
-        UARTCharPut(UART0_BASE, *str++);
+// Esvazia o log adiado no canal de logs da UART. Roda so no main loop, unico produtor do
+// buffer de TX; um registro so sai do log quando o quadro cabe inteiro.
+void DrainLog(void) {
+    uint8_t record[DLOG_RECORD_MAX];
+    uint32_t length;
+    while (UartTxFree() >= LINK_FRAME_MAX(DLOG_RECORD_MAX) && (length = DlogEncodeNext(record)) > 0) {
+        LinkSend(LINK_CH_LOGS, record, length);
     }
 }
 
@@ -205,11 +243,14 @@ int main(void) {
                 SYSCTL_USE_PLL | SYSCTL_CFG_VCO_240), 120000000);
 	
 
+    TimingInit(SysClock);
+    CmdParserInit(&commandParser, commands, sizeof(commands) / sizeof(commands[0]), CmdInvalid, NULL, CMD_FLAG_SINGLE_KEY);
     SetupSysTick();  // Inicializa o SysTick
     ConfigPeripherals();
     SetupUart();
 
     while (1) {
         __asm(" WFI");  // Aguardando interrupo
+        DrainLog();     // Toda ISR acorda o main loop
     }
 }
@@ -0,0 +1,95 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "driverlib/adc.h"
+#include "driverlib/timer.h"
+#include "timing.h"
+#include "adc_acq.h"
+
+#define ACQ_ADC         ADC0_BASE
+#define ACQ_SEQUENCER   3           // Um passo so, FIFO de 1 amostra
+#define ACQ_TIMER       TIMER0_BASE
+
+static AdcAcqDone acqDone;
+static uint32_t acqSamples;
+static uint32_t acqOverruns;
+static uint32_t acqLast;
+static uint32_t acqMinPeriod;
+static uint32_t acqMaxPeriod;
+
+static void AdcAcqIntHandler(void) {
+    uint32_t now = TimingNow();
+    uint32_t sample = 0;
+    ADCIntClear(ACQ_ADC, ACQ_SEQUENCER);
+    if (ADCSequenceOverflow(ACQ_ADC, ACQ_SEQUENCER)) {
+        ADCSequenceOverflowClear(ACQ_ADC, ACQ_SEQUENCER);
+        acqOverruns++;
+    }
+    ADCSequenceDataGet(ACQ_ADC, ACQ_SEQUENCER, &sample);
+
+    if (acqSamples > 0) {
+        uint32_t period = now - acqLast;
+        if (period < acqMinPeriod)
+            acqMinPeriod = period;
+        if (period > acqMaxPeriod)
+            acqMaxPeriod = period;
+    }
+    acqLast = now;
+    acqSamples++;
+    if (acqDone)
+        acqDone(sample);
+}
+
+bool AdcAcqInit(uint32_t clockHz, uint32_t rateHz, uint32_t oversample, AdcAcqDone done) {
+    if (rateHz == 0 || oversample == 0 || oversample > ADC_ACQ_OVERSAMPLE_MAX || (oversample & (oversample - 1)) != 0)
+        return false;
+    acqDone = done;
+    acqSamples = acqOverruns = acqMaxPeriod = 0;
+    acqMinPeriod = UINT32_MAX;
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_ADC0));
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOE));
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER0));
+    GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_3);
+
+    // Oversampling por hardware: a FIFO recebe a media de oversample conversoes
+    ADCSequenceDisable(ACQ_ADC, ACQ_SEQUENCER);
+    ADCHardwareOversampleConfigure(ACQ_ADC, oversample);
+    ADCSequenceConfigure(ACQ_ADC, ACQ_SEQUENCER, ADC_TRIGGER_TIMER, 0);
+    ADCSequenceStepConfigure(ACQ_ADC, ACQ_SEQUENCER, 0, ADC_CTL_CH0 | ADC_CTL_IE | ADC_CTL_END);
+    ADCSequenceEnable(ACQ_ADC, ACQ_SEQUENCER);
+    ADCIntClear(ACQ_ADC, ACQ_SEQUENCER);
+    ADCIntRegister(ACQ_ADC, ACQ_SEQUENCER, AdcAcqIntHandler);
+    ADCIntEnable(ACQ_ADC, ACQ_SEQUENCER);
+
+    // O timeout do Timer0A vira o gatilho do ADC; o timer nao gera interrupcao propria
+    TimerConfigure(ACQ_TIMER, TIMER_CFG_PERIODIC);
+    TimerLoadSet(ACQ_TIMER, TIMER_A, clockHz / rateHz - 1);
+    TimerControlTrigger(ACQ_TIMER, TIMER_A, true);
+    TimerADCEventSet(ACQ_TIMER, TIMER_ADC_TIMEOUT_A);
+    return true;
+}
+
+void AdcAcqStart(void) {
+    TimerEnable(ACQ_TIMER, TIMER_A);
+}
+
+void AdcAcqStop(void) {
+    TimerDisable(ACQ_TIMER, TIMER_A);
+}
+
+uint32_t AdcAcqSampleAge(void) {
+    return TimerLoadGet(ACQ_TIMER, TIMER_A) - TimerValueGet(ACQ_TIMER, TIMER_A);
+}
+
+void AdcAcqGetStats(AdcAcqStats *stats) {
+    stats->samples = acqSamples;
+    stats->overruns = acqOverruns;
+    stats->minPeriod = (acqSamples > 1) ? acqMinPeriod : 0;
+    stats->maxPeriod = acqMaxPeriod;
+}
@@ -0,0 +1,33 @@
+#ifndef ADC_ACQ_H
+#define ADC_ACQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Aquisicao do LDR (AIN0/PE3) sem a CPU esperar conversao: o Timer0A dispara o sequenciador
+// 3 do ADC0 por hardware, o ADC faz a media de oversample conversoes e a interrupcao de fim
+// de sequencia entrega o valor. O instante da amostra depende so do timer, nao do escalonador.
+#define ADC_ACQ_OVERSAMPLE_MAX  64
+
+// Chamada na ISR do ADC com cada amostra (media do oversampling, 0 a 4095)
+typedef void (*AdcAcqDone)(uint32_t sample);
+
+typedef struct {
+    uint32_t samples;
+    uint32_t overruns;      // Conversoes perdidas porque a ISR nao leu a FIFO a tempo
+    uint32_t minPeriod;     // Ciclos entre interrupcoes consecutivas (jitter = max - min)
+    uint32_t maxPeriod;
+} AdcAcqStats;
+
+// oversample: 1 (desligado) ou potencia de 2 ate ADC_ACQ_OVERSAMPLE_MAX. Usa o Timer0 inteiro.
+bool AdcAcqInit(uint32_t clockHz, uint32_t rateHz, uint32_t oversample, AdcAcqDone done);
+void AdcAcqStart(void);
+void AdcAcqStop(void);
+void AdcAcqGetStats(AdcAcqStats *stats);
+
+// Ciclos desde o disparo da amostra atual (o ultimo timeout do Timer0A, que conta no clock do
+// sistema). Chamada na callback, mede quanto a amostra ja envelheceu: conversao, entrada na
+// ISR e o que a aplicacao fez com ela. Vale ate o proximo disparo.
+uint32_t AdcAcqSampleAge(void);
+
+#endif // ADC_ACQ_H
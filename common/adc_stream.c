@@ -0,0 +1,188 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "adc_stream.h"
+
+#if defined(__arm__)
+#include "inc/hw_memmap.h"
+#include "inc/hw_adc.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "driverlib/adc.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
+#include "dma.h"
+
+#define STREAM_ADC          ADC0_BASE
+#define STREAM_SEQUENCER    0           // FIFO de 8 amostras
+#define STREAM_TIMER        TIMER0_BASE
+#define STREAM_DMA_CHANNEL  (UDMA_CH14_ADC0_0 & 0xFF)
+#else
+#include <stdio.h>
+#endif
+
+static uint16_t streamBuffers[2][ADC_STREAM_BLOCK_MAX];
+static volatile bool streamHeld[2];     // Bloco entregue e ainda nao liberado pela aplicacao
+static uint32_t streamLength;
+static AdcStreamBlock streamDone;
+static uint32_t streamBlocks;
+static uint32_t streamOverruns;
+static uint32_t streamFifoOverflows;
+
+// Entrega um bloco cheio; chamada na ISR (ou no laco de leitura do arquivo, no host)
+static void Complete(uint32_t half) {
+    if (streamHeld[half])
+        streamOverruns++;
+    streamHeld[half] = true;
+    streamBlocks++;
+    if (streamDone)
+        streamDone(streamBuffers[half], streamLength);
+}
+
+#if defined(__arm__)
+// Reprograma uma das estruturas do ping-pong para o seu bloco
+static void Arm(uint32_t half) {
+    uDMAChannelTransferSet(STREAM_DMA_CHANNEL | (half ? UDMA_ALT_SELECT : UDMA_PRI_SELECT), UDMA_MODE_PINGPONG,
+                           (void *)(STREAM_ADC + ADC_O_SSFIFO0), streamBuffers[half], streamLength);
+}
+
+static void AdcStreamIntHandler(void) {
+    ADCIntClearEx(STREAM_ADC, ADC_INT_DMA_SS0);
+    if (ADCSequenceOverflow(STREAM_ADC, STREAM_SEQUENCER)) {
+        ADCSequenceOverflowClear(STREAM_ADC, STREAM_SEQUENCER);
+        streamFifoOverflows++;
+    }
+
+    // Estrutura parada = bloco cheio; o uDMA ja esta no outro, ha um bloco inteiro para rearmar
+    for (uint32_t half = 0; half < 2; half++) {
+        if (uDMAChannelModeGet(STREAM_DMA_CHANNEL | (half ? UDMA_ALT_SELECT : UDMA_PRI_SELECT)) != UDMA_MODE_STOP)
+            continue;
+        Arm(half);
+        Complete(half);
+    }
+    // Se a ISR atrasou a ponto de os dois blocos fecharem, o canal desligou sozinho
+    if (!uDMAChannelIsEnabled(STREAM_DMA_CHANNEL))
+        uDMAChannelEnable(STREAM_DMA_CHANNEL);
+}
+
+bool AdcStreamInit(uint32_t clockHz, uint32_t rateHz, uint32_t blockLength, AdcStreamBlock done) {
+    if (rateHz == 0 || blockLength == 0 || blockLength > ADC_STREAM_BLOCK_MAX)
+        return false;
+    streamLength = blockLength;
+    streamDone = done;
+    streamBlocks = streamOverruns = streamFifoOverflows = 0;
+    streamHeld[0] = streamHeld[1] = false;
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_ADC0));
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOE));
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER0));
+    GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_3);
+
+    // Um passo por disparo: o IE de cada conversao pede ao uDMA, nao a CPU
+    ADCSequenceDisable(STREAM_ADC, STREAM_SEQUENCER);
+    ADCSequenceConfigure(STREAM_ADC, STREAM_SEQUENCER, ADC_TRIGGER_TIMER, 0);
+    ADCSequenceStepConfigure(STREAM_ADC, STREAM_SEQUENCER, 0, ADC_CTL_CH0 | ADC_CTL_IE | ADC_CTL_END);
+    ADCSequenceEnable(STREAM_ADC, STREAM_SEQUENCER);
+    ADCSequenceDMAEnable(STREAM_ADC, STREAM_SEQUENCER);
+
+    DmaInit();
+    uDMAChannelAssign(UDMA_CH14_ADC0_0);
+    uDMAChannelAttributeDisable(STREAM_DMA_CHANNEL, UDMA_ATTR_ALTSELECT | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    uDMAChannelAttributeEnable(STREAM_DMA_CHANNEL, UDMA_ATTR_USEBURST);
+    uDMAChannelControlSet(STREAM_DMA_CHANNEL | UDMA_PRI_SELECT, UDMA_SIZE_16 | UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+    uDMAChannelControlSet(STREAM_DMA_CHANNEL | UDMA_ALT_SELECT, UDMA_SIZE_16 | UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+
+    // So a interrupcao de fim de transferencia do uDMA chega a CPU
+    ADCIntClearEx(STREAM_ADC, ADC_INT_DMA_SS0);
+    ADCIntRegister(STREAM_ADC, STREAM_SEQUENCER, AdcStreamIntHandler);
+    ADCIntEnableEx(STREAM_ADC, ADC_INT_DMA_SS0);
+
+    TimerConfigure(STREAM_TIMER, TIMER_CFG_PERIODIC);
+    TimerLoadSet(STREAM_TIMER, TIMER_A, clockHz / rateHz - 1);
+    TimerControlTrigger(STREAM_TIMER, TIMER_A, true);
+    TimerADCEventSet(STREAM_TIMER, TIMER_ADC_TIMEOUT_A);
+    return true;
+}
+
+void AdcStreamStart(void) {
+    Arm(0);
+    Arm(1);
+    uDMAChannelEnable(STREAM_DMA_CHANNEL);
+    TimerEnable(STREAM_TIMER, TIMER_A);
+}
+
+void AdcStreamStop(void) {
+    TimerDisable(STREAM_TIMER, TIMER_A);
+}
+#else
+static FILE *streamFile;
+static volatile bool streamRunning;
+
+bool AdcStreamInit(uint32_t clockHz, uint32_t rateHz, uint32_t blockLength, AdcStreamBlock done) {
+    (void)clockHz;      // No host o ritmo e o da leitura do arquivo
+    if (rateHz == 0 || blockLength == 0 || blockLength > ADC_STREAM_BLOCK_MAX)
+        return false;
+    streamLength = blockLength;
+    streamDone = done;
+    streamBlocks = streamOverruns = streamFifoOverflows = 0;
+    streamHeld[0] = streamHeld[1] = false;
+    return true;
+}
+
+bool AdcStreamOpenFile(const char *path) {
+    if (streamFile != NULL)
+        fclose(streamFile);
+    streamFile = fopen(path, "r");
+    return streamFile != NULL;
+}
+
+void AdcStreamStart(void) {
+    uint32_t half = 0;
+    uint32_t count = 0;
+    unsigned long value;
+    streamRunning = true;
+    while (streamRunning && streamFile != NULL && fscanf(streamFile, "%lu", &value) == 1) {
+        streamBuffers[half][count++] = (uint16_t)(value > 4095 ? 4095 : value);
+        if (count == streamLength) {
+            Complete(half);
+            half ^= 1;
+            count = 0;
+        }
+    }
+    streamRunning = false;
+}
+
+void AdcStreamStop(void) {
+    streamRunning = false;
+}
+#endif
+
+void AdcStreamRelease(const uint16_t *block) {
+    streamHeld[block == streamBuffers[1]] = false;
+}
+
+void AdcStreamGetStats(AdcStreamStats *stats) {
+    stats->blocks = streamBlocks;
+    stats->overruns = streamOverruns;
+    stats->fifoOverflows = streamFifoOverflows;
+}
+
+void AdcStreamSummarize(const uint16_t *block, uint32_t count, AdcBlockSummary *summary) {
+    uint16_t min = UINT16_MAX;
+    uint16_t max = 0;
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t sample = block[i] & 0x0FFF;    // A FIFO do ADC so tem 12 bits validos
+        if (sample < min)
+            min = sample;
+        if (sample > max)
+            max = sample;
+        sum += sample;
+    }
+    summary->min = (count > 0) ? min : 0;
+    summary->max = max;
+    summary->sum = sum;
+}
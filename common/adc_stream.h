@@ -0,0 +1,49 @@
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Aquisicao continua do LDR (AIN0/PE3) em blocos, para taxas de dezenas de kHz. O Timer0A
+// dispara o sequenciador 0 do ADC0 a cada amostra; a FIFO de 8 posicoes segura as conversoes
+// enquanto o uDMA atende outro canal, e o uDMA em ping-pong enche dois blocos alternados.
+// So ha interrupcao quando um bloco fecha, nunca por amostra. Usa o mesmo Timer0/ADC0 que
+// adc_acq: a aplicacao escolhe um dos dois.
+//
+// Fora do alvo (sem __arm__) as amostras vem de um arquivo gravado (AdcStreamOpenFile) e
+// AdcStreamStart entrega todos os blocos ao callback antes de retornar.
+#define ADC_STREAM_BLOCK_MAX    512     // Amostras por bloco (dois blocos em RAM)
+
+// Chamada na ISR com o bloco que acabou de encher. O bloco pertence a aplicacao ate
+// AdcStreamRelease; se o uDMA voltar a ele antes disso, o bloco e sobrescrito e conta overrun.
+typedef void (*AdcStreamBlock)(const uint16_t *block, uint32_t count);
+
+typedef struct {
+    uint32_t blocks;
+    uint32_t overruns;      // Blocos reescritos antes de AdcStreamRelease
+    uint32_t fifoOverflows; // Conversoes perdidas porque o uDMA nao esvaziou a FIFO a tempo
+} AdcStreamStats;
+
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+} AdcBlockSummary;
+
+// blockLength: 1 a ADC_STREAM_BLOCK_MAX. Usa o Timer0 inteiro e o canal 14 do uDMA.
+bool AdcStreamInit(uint32_t clockHz, uint32_t rateHz, uint32_t blockLength, AdcStreamBlock done);
+void AdcStreamStart(void);
+void AdcStreamStop(void);
+void AdcStreamRelease(const uint16_t *block);
+void AdcStreamGetStats(AdcStreamStats *stats);
+
+// Minimo, maximo e soma de um bloco (o mesmo codigo no alvo e no host)
+void AdcStreamSummarize(const uint16_t *block, uint32_t count, AdcBlockSummary *summary);
+
+#if !defined(__arm__)
+// Amostras em texto, separadas por espaco ou quebra de linha (0 a 4095). Um bloco incompleto
+// no fim do arquivo e descartado, como no alvo.
+bool AdcStreamOpenFile(const char *path);
+#endif
+
+#endif // ADC_STREAM_H
@@ -0,0 +1,57 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "change_gate.h"
+
+void ChangeGateInit(ChangeGate *gate, const ChangeGateConfig *config) {
+    gate->config = *config;
+    gate->primed = false;
+    gate->last = 0;
+    gate->lastMs = 0;
+    gate->stats = (ChangeGateStats){0};
+}
+
+static bool Changed(const ChangeGate *gate, int32_t value) {
+    int64_t diff = (int64_t)value - gate->last;
+    uint64_t delta = (uint64_t)((diff < 0) ? -diff : diff);
+    uint64_t reference = (uint64_t)((gate->last < 0) ? -(int64_t)gate->last : gate->last);
+    if (gate->config.absolute == 0 && gate->config.relativePermille == 0)
+        return delta != 0;
+    if (gate->config.absolute != 0 && delta >= gate->config.absolute)
+        return true;
+    return gate->config.relativePermille != 0 && delta * 1000 >= reference * gate->config.relativePermille && delta != 0;
+}
+
+static bool Offer(ChangeGate *gate, int32_t value, uint32_t nowMs, bool force) {
+    gate->stats.offered++;
+    if (gate->primed) {
+        uint32_t elapsed = nowMs - gate->lastMs;
+        bool changed = force || Changed(gate, value);
+        bool silent = gate->config.maxSilenceMs != 0 && elapsed >= gate->config.maxSilenceMs;
+        if (!changed && !silent)
+            return false;
+        if (elapsed < gate->config.minIntervalMs) {
+            if (changed)
+                gate->stats.rateLimited++;
+            return false;
+        }
+        if (!changed)
+            gate->stats.heartbeats++;
+    }
+    gate->primed = true;
+    gate->last = value;
+    gate->lastMs = nowMs;
+    gate->stats.published++;
+    return true;
+}
+
+bool ChangeGateOffer(ChangeGate *gate, int32_t value, uint32_t nowMs) {
+    return Offer(gate, value, nowMs, false);
+}
+
+bool ChangeGateForce(ChangeGate *gate, int32_t value, uint32_t nowMs) {
+    return Offer(gate, value, nowMs, true);
+}
+
+void ChangeGateGetStats(const ChangeGate *gate, ChangeGateStats *stats) {
+    *stats = gate->stats;
+}
@@ -0,0 +1,48 @@
+#ifndef CHANGE_GATE_H
+#define CHANGE_GATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Decide se uma leitura vale ser enviada: so quando sai da faixa morta em torno do ultimo
+// valor publicado, com um intervalo minimo entre envios (limitador de taxa) e um envio
+// forcado depois de um silencio maximo, para o host saber que o sensor continua vivo.
+// Fica entre o pipeline do sensor e a UART; a aplicacao chama ChangeGateOffer com cada
+// leitura e so formata e envia quando ele devolve true. Sem trava: uma thread por gate.
+typedef struct {
+    uint32_t absolute;          // Variacao minima em unidades do valor (0 = nao usa)
+    uint32_t relativePermille;  // Variacao minima em milesimos do ultimo publicado (0 = nao usa)
+    uint32_t minIntervalMs;     // Intervalo minimo entre envios (0 = sem limite)
+    uint32_t maxSilenceMs;      // Envia mesmo sem mudanca depois disso (0 = nunca)
+} ChangeGateConfig;
+
+typedef struct {
+    uint32_t offered;
+    uint32_t published;
+    uint32_t heartbeats;        // Envios so por silencio
+    uint32_t rateLimited;       // Mudancas adiadas pelo intervalo minimo
+} ChangeGateStats;
+
+typedef struct {
+    ChangeGateConfig config;
+    bool primed;
+    int32_t last;               // Ultimo valor publicado
+    uint32_t lastMs;
+    ChangeGateStats stats;
+} ChangeGate;
+
+// Com absolute e relativePermille em 0, qualquer diferenca conta como mudanca
+void ChangeGateInit(ChangeGate *gate, const ChangeGateConfig *config);
+
+// nowMs: relogio em ms da aplicacao (pode dar a volta). A primeira leitura sempre passa.
+// Uma mudanca barrada pelo limitador passa na primeira oferta depois do intervalo, se o
+// valor ainda estiver fora da faixa.
+bool ChangeGateOffer(ChangeGate *gate, int32_t value, uint32_t nowMs);
+
+// Como ChangeGateOffer, mas conta como mudanca mesmo dentro da faixa morta (a aplicacao viu
+// mudar outra coisa que vai no mesmo envio); o intervalo minimo continua valendo
+bool ChangeGateForce(ChangeGate *gate, int32_t value, uint32_t nowMs);
+
+void ChangeGateGetStats(const ChangeGate *gate, ChangeGateStats *stats);
+
+#endif // CHANGE_GATE_H
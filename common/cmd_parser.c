@@ -0,0 +1,185 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "timing.h"
+#include "cmd_parser.h"
+
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+enum {
+    STATE_IDLE = 0,     // Entre tokens
+    STATE_WORD,
+    STATE_NUMBER
+};
+
+static bool IsLetter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+uint32_t CmdHash(const char *text, uint32_t length) {
+    uint32_t hash = FNV_OFFSET;
+    for (uint32_t i = 0; i < length; i++)
+        hash = (hash ^ (uint8_t)text[i]) * FNV_PRIME;
+    return hash;
+}
+
+bool CmdTokenIs(const CmdToken *token, const char *word) {
+    uint32_t length = strlen(word);
+    return token->type == CMD_TOKEN_WORD && token->length == length && length <= CMD_TEXT_MAX &&
+           memcmp(token->text, word, length) == 0;
+}
+
+bool CmdParserInit(CmdParser *parser, const CmdEntry *table, uint32_t tableSize, CmdHandler fallback, void *context, uint8_t flags) {
+    parser->table = table;
+    parser->tableSize = tableSize;
+    parser->fallback = fallback;
+    parser->context = context;
+    parser->flags = flags;
+    parser->count = 0;
+    parser->state = STATE_IDLE;
+    parser->overflow = false;
+    parser->lineCycles = 0;
+    parser->stats = (CmdParserStats){0};
+    for (uint32_t b = 0; b < CMD_BUCKETS; b++)
+        parser->buckets[b] = 0;
+    if (tableSize > CMD_MAX_COMMANDS)
+        return false;
+
+    // Enderecamento aberto com sondagem linear; a tabela e pequena, a sondagem quase nunca anda
+    for (uint32_t i = 0; i < tableSize; i++) {
+        uint32_t length = 0;
+        while (table[i].name[length] != '\0')
+            length++;
+        if (length > CMD_TEXT_MAX)
+            return false;
+        uint32_t hash = CmdHash(table[i].name, length);
+        uint32_t b = hash & (CMD_BUCKETS - 1);
+        while (parser->buckets[b] != 0) {
+            uint32_t other = parser->buckets[b] - 1;
+            if (parser->hashes[other] == hash && parser->lengths[other] == length)
+                return false;
+            b = (b + 1) & (CMD_BUCKETS - 1);
+        }
+        parser->hashes[i] = hash;
+        parser->lengths[i] = (uint8_t)length;
+        parser->buckets[b] = (uint8_t)(i + 1);
+    }
+    return true;
+}
+
+static const CmdEntry *Lookup(const CmdParser *parser, const CmdToken *token) {
+    if (token->type != CMD_TOKEN_WORD && token->type != CMD_TOKEN_NUMBER)
+        return NULL;
+    for (uint32_t b = token->hash & (CMD_BUCKETS - 1); parser->buckets[b] != 0; b = (b + 1) & (CMD_BUCKETS - 1)) {
+        uint32_t i = parser->buckets[b] - 1;
+        if (parser->hashes[i] == token->hash && parser->lengths[i] == token->length &&
+            memcmp(parser->table[i].name, token->text, token->length) == 0)
+            return &parser->table[i];
+    }
+    return NULL;
+}
+
+static CmdToken *NewToken(CmdParser *parser, CmdTokenType type) {
+    if (parser->count == CMD_MAX_TOKENS) {
+        parser->overflow = true;
+        return NULL;
+    }
+    CmdToken *token = &parser->tokens[parser->count++];
+    *token = (CmdToken){.type = (uint8_t)type, .hash = FNV_OFFSET};
+    return token;
+}
+
+// Fecha a linha: procura o comando e chama o handler; devolve os ciclos gastos no handler
+static uint32_t EndLine(CmdParser *parser) {
+    uint32_t handlerCycles = 0;
+    if (parser->count > 0 || parser->overflow) {
+        const CmdEntry *entry = parser->overflow ? NULL : Lookup(parser, &parser->tokens[0]);
+        uint32_t start = TimingNow();
+        if (entry != NULL) {
+            entry->handler(parser->tokens + 1, parser->count - 1, parser->context);
+        } else if (parser->fallback != NULL && !parser->overflow) {
+            parser->fallback(parser->tokens, parser->count, parser->context);
+        } else {
+            parser->stats.errors++;
+        }
+        handlerCycles = TimingNow() - start;
+        parser->stats.lines++;
+    }
+    parser->count = 0;
+    parser->state = STATE_IDLE;
+    parser->overflow = false;
+    return handlerCycles;
+}
+
+void CmdParserFeed(CmdParser *parser, const char *data, uint32_t length) {
+    uint32_t start = TimingNow();
+    for (uint32_t i = 0; i < length; i++) {
+        char c = data[i];
+        bool end = c == '\r' || c == '\n';
+        if (parser->flags & CMD_FLAG_SINGLE_KEY)
+            end = end || c > ' ';
+
+        // Continua o token atual ou abre um novo conforme a classe do caractere
+        if (IsLetter(c)) {
+            CmdToken *token = (parser->state == STATE_WORD) ? &parser->tokens[parser->count - 1] : NewToken(parser, CMD_TOKEN_WORD);
+            parser->state = token ? STATE_WORD : STATE_IDLE;
+            if (token) {
+                token->hash = (token->hash ^ (uint8_t)c) * FNV_PRIME;
+                if (token->length < CMD_TEXT_MAX)
+                    token->text[token->length] = c;
+                if (token->length < UINT8_MAX)     // Nao volta a zero nas linhas enormes
+                    token->length++;
+                if (c >= 'a' && c <= 'z')
+                    token->letters |= 1u << (c - 'a');
+            }
+        } else if (IsDigit(c)) {
+            CmdToken *token = (parser->state == STATE_NUMBER) ? &parser->tokens[parser->count - 1] : NewToken(parser, CMD_TOKEN_NUMBER);
+            parser->state = token ? STATE_NUMBER : STATE_IDLE;
+            if (token) {
+                uint32_t digit = (uint32_t)(c - '0');
+                token->hash = (token->hash ^ (uint8_t)c) * FNV_PRIME;
+                if (token->length < CMD_TEXT_MAX)
+                    token->text[token->length] = c;
+                if (token->length < UINT8_MAX)     // Nao volta a zero nas linhas enormes
+                    token->length++;
+                if (token->value > (UINT32_MAX - digit) / 10)
+                    token->type = CMD_TOKEN_INVALID;    // Nao satura: o handler recusa o token
+                else
+                    token->value = token->value * 10 + digit;
+            }
+        } else if (c > ' ' && c < 0x7F) {
+            CmdToken *token = NewToken(parser, CMD_TOKEN_PUNCT);
+            if (token) {
+                token->punct = c;
+                token->length = 1;
+            }
+            parser->state = STATE_IDLE;
+        } else {
+            parser->state = STATE_IDLE;
+        }
+
+        if (end) {
+            uint32_t lines = parser->stats.lines;
+            uint32_t handler = EndLine(parser);
+            uint32_t cycles = parser->lineCycles + (TimingNow() - start) - handler;
+            if (parser->stats.lines != lines) {     // Linhas vazias nao entram na media
+                parser->stats.cycles += cycles;
+                if (cycles > parser->stats.maxCycles)
+                    parser->stats.maxCycles = cycles;
+            }
+            parser->lineCycles = 0;
+            start = TimingNow();
+        }
+    }
+    parser->lineCycles += TimingNow() - start;
+}
+
+void CmdParserGetStats(const CmdParser *parser, CmdParserStats *stats) {
+    *stats = parser->stats;
+}
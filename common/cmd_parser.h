@@ -0,0 +1,81 @@
+#ifndef CMD_PARSER_H
+#define CMD_PARSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Interpretador de comandos por tabela. Uma maquina de estados consome os bytes direto dos
+// trechos do buffer de RX (sem copiar a linha nem usar heap) e gera tokens ja convertidos:
+// palavras viram hash FNV-1a, numeros viram valor. A primeira palavra/numero de cada linha
+// escolhe o comando num indice hash montado em CmdParserInit (O(1) por linha); o hash so
+// acha o candidato, o nome e confirmado com os caracteres guardados no token.
+#define CMD_MAX_TOKENS      24      // Tokens por linha (o excesso descarta a linha)
+#define CMD_MAX_COMMANDS    16
+#define CMD_BUCKETS         32      // Potencia de 2, maior que CMD_MAX_COMMANDS
+#define CMD_TEXT_MAX        12      // Caracteres guardados por token (maior nome de comando)
+
+#define CMD_FLAG_SINGLE_KEY 0x01    // Cada tecla e uma linha completa (sem Enter)
+
+typedef enum {
+    CMD_TOKEN_WORD = 0,     // Letras: hash, length e letters
+    CMD_TOKEN_NUMBER,       // Digitos decimais: value, hash e length
+    CMD_TOKEN_PUNCT,        // Qualquer outro caractere visivel, em punct
+    CMD_TOKEN_INVALID       // Numero que nao cabe em 32 bits (nenhum handler o aceita)
+} CmdTokenType;
+
+typedef struct {
+    uint8_t type;           // CmdTokenType
+    uint8_t length;
+    char punct;
+    uint32_t hash;
+    uint32_t value;
+    uint32_t letters;       // Bit (c - 'a') de cada letra minuscula da palavra
+    char text[CMD_TEXT_MAX];    // Primeiros caracteres da palavra/numero, sem terminador
+} CmdToken;
+
+// args aponta para os tokens depois do nome do comando (ou para todos, no fallback)
+typedef void (*CmdHandler)(const CmdToken *args, uint32_t count, void *context);
+
+typedef struct {
+    const char *name;
+    CmdHandler handler;
+} CmdEntry;
+
+typedef struct {
+    uint32_t lines;         // Linhas despachadas
+    uint32_t errors;        // Linhas sem comando, sem fallback ou com tokens demais
+    uint32_t cycles;        // Ciclos gastos interpretando (sem contar os handlers)
+    uint32_t maxCycles;     // Pior linha
+} CmdParserStats;
+
+typedef struct {
+    const CmdEntry *table;
+    uint32_t tableSize;
+    CmdHandler fallback;    // Linhas que nao comecam por um comando da tabela (pode ser NULL)
+    void *context;
+    uint8_t flags;
+    uint8_t buckets[CMD_BUCKETS];       // Indice+1 na tabela, 0 = vazio
+    uint32_t hashes[CMD_MAX_COMMANDS];
+    uint8_t lengths[CMD_MAX_COMMANDS];
+
+    // Estado da linha em andamento
+    CmdToken tokens[CMD_MAX_TOKENS];
+    uint32_t count;
+    uint8_t state;
+    bool overflow;
+    uint32_t lineCycles;
+    CmdParserStats stats;
+} CmdParser;
+
+// Falha com tabela grande demais, nomes repetidos ou com mais de CMD_TEXT_MAX caracteres
+bool CmdParserInit(CmdParser *parser, const CmdEntry *table, uint32_t tableSize, CmdHandler fallback, void *context, uint8_t flags);
+void CmdParserFeed(CmdParser *parser, const char *data, uint32_t length);
+void CmdParserGetStats(const CmdParser *parser, CmdParserStats *stats);
+
+// Hash usado para os nomes
+uint32_t CmdHash(const char *text, uint32_t length);
+
+// Compara uma palavra de argumento com uma constante (tamanho e caracteres)
+bool CmdTokenIs(const CmdToken *token, const char *word);
+
+#endif // CMD_PARSER_H
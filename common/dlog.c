@@ -0,0 +1,88 @@
+#include <stdint.h>
+#include "TM4C129.h"
+#include "timing.h"
+#include "dlog.h"
+
+#define DLOG_RING_MASK  (DLOG_RING_SIZE - 1)
+
+typedef struct {
+    volatile uint32_t ready;    // O produtor terminou de preencher o registro
+    uint16_t id;
+    uint8_t nargs;
+    uint32_t time;
+    uint32_t args[DLOG_MAX_ARGS];
+} DlogRecord;
+
+// Varios produtores (ISRs e threads) reservam posicoes com LDREX/STREX; um consumidor so
+static DlogRecord dlogRing[DLOG_RING_SIZE];
+static volatile uint32_t dlogHead;
+static volatile uint32_t dlogTail;
+static volatile uint32_t dlogWritten;
+static volatile uint32_t dlogDropped;
+
+static void AtomicIncrement(volatile uint32_t *counter) {
+    uint32_t value;
+    do {
+        value = __LDREXW(counter) + 1;
+    } while (__STREXW(value, counter));
+}
+
+void DlogWrite(uint16_t id, uint32_t nargs, uint32_t a0, uint32_t a1, uint32_t a2) {
+    uint32_t head;
+    do {
+        head = __LDREXW(&dlogHead);
+        if (head - dlogTail >= DLOG_RING_SIZE) {
+            __CLREX();
+            AtomicIncrement(&dlogDropped);
+            return;
+        }
+    } while (__STREXW(head + 1, &dlogHead));
+
+    DlogRecord *record = &dlogRing[head & DLOG_RING_MASK];
+    record->id = id;
+    record->nargs = (uint8_t)nargs;
+    record->time = TimingNow();
+    record->args[0] = a0;
+    record->args[1] = a1;
+    record->args[2] = a2;
+    __DMB();
+    record->ready = 1;
+    AtomicIncrement(&dlogWritten);
+}
+
+static uint8_t *Put32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+uint32_t DlogEncodeNext(uint8_t *out) {
+    uint32_t tail = dlogTail;
+    if (tail == dlogHead)
+        return 0;
+    DlogRecord *record = &dlogRing[tail & DLOG_RING_MASK];
+    if (!record->ready)
+        return 0;       // Produtor interrompido no meio do registro: fica para a proxima
+    __DMB();
+
+    uint8_t *p = out;
+    uint32_t nargs = (record->nargs <= DLOG_MAX_ARGS) ? record->nargs : DLOG_MAX_ARGS;
+    *p++ = (uint8_t)record->id;
+    *p++ = (uint8_t)(record->id >> 8);
+    *p++ = (uint8_t)nargs;
+    p = Put32(p, record->time);
+    for (uint32_t i = 0; i < nargs; i++)
+        p = Put32(p, record->args[i]);
+
+    record->ready = 0;
+    __DMB();
+    dlogTail = tail + 1;
+    return (uint32_t)(p - out);
+}
+
+void DlogGetStats(DlogStats *stats) {
+    stats->written = dlogWritten;
+    stats->dropped = dlogDropped;
+}
@@ -0,0 +1,41 @@
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdint.h>
+
+// Log binario adiado: o caminho quente grava so o ID do formato e os argumentos crus num
+// buffer circular (dezenas de ciclos, seguro em ISR). Um dreno de baixa prioridade codifica
+// os registros e os envia no canal LINK_CH_LOGS (common/link.h); o host (host/link_cat.cpp)
+// refaz o texto.
+//
+// Cada aplicacao lista seus formatos num log_formats.h com um X-macro compartilhado com o host:
+//   #define LOG_FORMATS(X) X(LOG_TEMPO, "Tempo: %u segundos\r\n") ...
+//   enum { LOG_FORMATS(DLOG_ENUM) LOG_COUNT };
+#define DLOG_ENUM(id, format)   id,
+#define DLOG_STRING(id, format) format,
+
+#define DLOG_MAX_ARGS   3
+#define DLOG_RING_SIZE  64      // Registros; potencia de 2
+
+// Registro codificado: id (16 bits), nargs, timestamp em ciclos (32 bits) e nargs x 32 bits,
+// tudo little-endian
+#define DLOG_RECORD_MAX (2 + 1 + 4 + 4 * DLOG_MAX_ARGS)
+
+typedef struct {
+    uint32_t written;       // Registros gravados
+    uint32_t dropped;       // Registros perdidos com o buffer cheio
+} DlogStats;
+
+void DlogWrite(uint16_t id, uint32_t nargs, uint32_t a0, uint32_t a1, uint32_t a2);
+
+#define DLOG0(id)               DlogWrite((id), 0, 0, 0, 0)
+#define DLOG1(id, a)            DlogWrite((id), 1, (a), 0, 0)
+#define DLOG2(id, a, b)         DlogWrite((id), 2, (a), (b), 0)
+#define DLOG3(id, a, b, c)      DlogWrite((id), 3, (a), (b), (c))
+
+// Dreno (um consumidor so): codifica o proximo registro em record (DLOG_RECORD_MAX bytes)
+// e devolve seu tamanho, ou 0 se nao houver registro pronto
+uint32_t DlogEncodeNext(uint8_t *record);
+void DlogGetStats(DlogStats *stats);
+
+#endif // DLOG_H
@@ -0,0 +1,19 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
+#include "dma.h"
+
+// O controlador exige a tabela alinhada em 1024 bytes (32 canais x primario/alternativo)
+static uint8_t dmaControlTable[1024] __attribute__((aligned(1024)));
+static bool dmaReady;
+
+void DmaInit(void) {
+    if (dmaReady)
+        return;
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA));
+    uDMAEnable();
+    uDMAControlBaseSet(dmaControlTable);
+    dmaReady = true;
+}
@@ -0,0 +1,8 @@
+#ifndef DMA_H
+#define DMA_H
+
+// Tabela de controle unica do uDMA, compartilhada por todos os modulos que usam DMA.
+// Pode ser chamada mais de uma vez; so a primeira chamada configura o controlador.
+void DmaInit(void);
+
+#endif // DMA_H
@@ -0,0 +1,240 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "timing.h"
+#include "filter.h"
+
+#if defined(__arm__)
+#include "TM4C129.h"
+#define SMLAD(x, y, acc)    ((int32_t)__SMLAD((x), (y), (uint32_t)(acc)))
+#define SMLALD(x, y, acc)   ((int64_t)__SMLALD((x), (y), (uint64_t)(acc)))
+#define SAT16(value)        __SSAT((value), 16)
+#else
+// Mesma semantica das instrucoes do Cortex-M4: produtos das metades de 16 bits com sinal,
+// somados ao acumulador (o de 32 bits da a volta, como o SMLAD)
+static int32_t SMLAD(uint32_t x, uint32_t y, int32_t acc) {
+    int64_t sum = (int64_t)(int16_t)x * (int16_t)y + (int64_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+    return (int32_t)(uint32_t)((uint64_t)acc + (uint64_t)sum);
+}
+
+static int64_t SMLALD(uint32_t x, uint32_t y, int64_t acc) {
+    return acc + (int64_t)(int16_t)x * (int16_t)y + (int64_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+}
+
+static int32_t SAT16(int32_t value) {
+    return (value > INT16_MAX) ? INT16_MAX : (value < INT16_MIN) ? INT16_MIN : value;
+}
+#endif
+
+// Duas amostras vizinhas num registrador (a primeira na metade de baixo); LDR desalinhado
+// e permitido no M4
+static uint32_t Load2(const int16_t *p) {
+    uint32_t pair;
+    memcpy(&pair, p, sizeof(pair));
+    return pair;
+}
+
+static uint32_t Pack(int16_t low, int16_t high) {
+    return (uint16_t)low | ((uint32_t)(uint16_t)high << 16);
+}
+
+static void ProcessFir(FilterFir *fir, int16_t *samples, uint32_t count) {
+    uint32_t taps = fir->taps;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t pos = fir->pos;
+        fir->history[pos] = fir->history[pos + taps] = samples[i];
+        const int16_t *window = &fir->history[pos + 1];     // Da mais antiga para a atual
+
+        int32_t acc = 1 << 14;
+        for (uint32_t j = 0; j < taps; j += 2)
+            acc = SMLAD(Load2(window + j), Load2(fir->coeffs + j), acc);
+        samples[i] = (int16_t)SAT16(acc >> 15);
+        fir->pos = (pos + 1 == taps) ? 0 : pos + 1;
+    }
+}
+
+static void ProcessBiquad(FilterBiquad *bq, int16_t *samples, uint32_t count) {
+    uint32_t b01 = Pack(bq->b0, bq->b1);
+    uint32_t b2a1 = Pack(bq->b2, bq->na1);
+    for (uint32_t i = 0; i < count; i++) {
+        int16_t x0 = samples[i];
+        int64_t acc = 1 << 13;
+        acc = SMLALD(Pack(x0, bq->x1), b01, acc);
+        acc = SMLALD(Pack(bq->x2, bq->y1), b2a1, acc);
+        acc += (int32_t)bq->na2 * bq->y2;
+        int16_t y = (int16_t)SAT16((int32_t)(acc >> 14));
+        bq->x2 = bq->x1;
+        bq->x1 = x0;
+        bq->y2 = bq->y1;
+        bq->y1 = y;
+        samples[i] = y;
+    }
+}
+
+// Janela ordenada mantida por insercao: tira a amostra que sai e encaixa a nova, O(janela)
+static void ProcessMedian(FilterMedian *median, int16_t *samples, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        int16_t x = samples[i];
+        uint32_t n = median->count;
+        if (n == median->window) {
+            int16_t old = median->ring[median->pos];
+            uint32_t k = 0;
+            while (median->sorted[k] != old)
+                k++;
+            for (n--; k < n; k++)
+                median->sorted[k] = median->sorted[k + 1];
+        }
+        median->ring[median->pos] = x;
+        median->pos = (median->pos + 1 == median->window) ? 0 : median->pos + 1;
+
+        uint32_t k = n;
+        while (k > 0 && median->sorted[k - 1] > x) {
+            median->sorted[k] = median->sorted[k - 1];
+            k--;
+        }
+        median->sorted[k] = x;
+        median->count = n + 1;
+        samples[i] = median->sorted[n / 2];
+    }
+}
+
+static void ProcessEma(FilterEma *ema, int16_t *samples, uint32_t count) {
+    uint32_t i = 0;
+    if (!ema->primed && count > 0) {
+        ema->state = (int32_t)samples[0] * 65536;
+        ema->primed = true;
+        i = 1;
+    }
+    for (; i < count; i++) {
+        int64_t diff = (int64_t)samples[i] * 65536 - ema->state;
+        ema->state += (int32_t)((diff * ema->alpha) >> 15);
+        samples[i] = (int16_t)SAT16((int32_t)(((int64_t)ema->state + (1 << 15)) >> 16));
+    }
+}
+
+static FilterStage *NewStage(FilterChain *chain, FilterType type) {
+    if (chain->count == FILTER_STAGES_MAX)
+        return NULL;
+    FilterStage *stage = &chain->stages[chain->count++];
+    memset(stage, 0, sizeof(*stage));
+    stage->type = (uint8_t)type;
+    return stage;
+}
+
+void FilterChainInit(FilterChain *chain) {
+    chain->count = 0;
+}
+
+bool FilterChainAddFir(FilterChain *chain, const int16_t *coeffs, uint32_t taps) {
+    uint32_t gain = 0;
+    for (uint32_t k = 0; k < taps; k++)
+        gain += (uint32_t)((coeffs[k] < 0) ? -coeffs[k] : coeffs[k]);
+    if (taps == 0 || taps > FILTER_FIR_TAPS_MAX || gain > 32768)
+        return false;
+    FilterStage *stage = NewStage(chain, FILTER_FIR);
+    if (stage == NULL)
+        return false;
+
+    // Numero impar de taps ganha um coeficiente zero no lado mais antigo
+    uint32_t even = (taps + 1) & ~1u;
+    stage->fir.taps = even;
+    for (uint32_t j = 0; j < even; j++)
+        stage->fir.coeffs[j] = (even - 1 - j < taps) ? coeffs[even - 1 - j] : 0;
+    return true;
+}
+
+bool FilterChainAddBiquad(FilterChain *chain, const int16_t coeffs[5]) {
+    if (coeffs[3] == INT16_MIN || coeffs[4] == INT16_MIN)
+        return false;
+    FilterStage *stage = NewStage(chain, FILTER_BIQUAD);
+    if (stage == NULL)
+        return false;
+    stage->biquad.b0 = coeffs[0];
+    stage->biquad.b1 = coeffs[1];
+    stage->biquad.b2 = coeffs[2];
+    stage->biquad.na1 = (int16_t)-coeffs[3];
+    stage->biquad.na2 = (int16_t)-coeffs[4];
+    return true;
+}
+
+bool FilterChainAddMedian(FilterChain *chain, uint32_t window) {
+    if (window == 0 || window > FILTER_MEDIAN_MAX)
+        return false;
+    FilterStage *stage = NewStage(chain, FILTER_MEDIAN);
+    if (stage == NULL)
+        return false;
+    stage->median.window = window;
+    return true;
+}
+
+bool FilterChainAddEma(FilterChain *chain, int16_t alpha) {
+    if (alpha <= 0)
+        return false;
+    FilterStage *stage = NewStage(chain, FILTER_EMA);
+    if (stage == NULL)
+        return false;
+    stage->ema.alpha = alpha;
+    return true;
+}
+
+void FilterChainReset(FilterChain *chain) {
+    for (uint32_t i = 0; i < chain->count; i++) {
+        FilterStage *stage = &chain->stages[i];
+        switch (stage->type) {
+            case FILTER_FIR:
+                stage->fir.pos = 0;
+                memset(stage->fir.history, 0, sizeof(stage->fir.history));
+                break;
+            case FILTER_BIQUAD:
+                stage->biquad.x1 = stage->biquad.x2 = stage->biquad.y1 = stage->biquad.y2 = 0;
+                break;
+            case FILTER_MEDIAN:
+                stage->median.count = stage->median.pos = 0;
+                break;
+            case FILTER_EMA:
+                stage->ema.primed = false;
+                stage->ema.state = 0;
+                break;
+        }
+        stage->samples = stage->cycles = 0;
+    }
+}
+
+void FilterChainResetStats(FilterChain *chain) {
+    for (uint32_t i = 0; i < chain->count; i++)
+        chain->stages[i].samples = chain->stages[i].cycles = 0;
+}
+
+// Um estagio de cada vez sobre o bloco inteiro: o laco interno fica sem desvios por tipo
+void FilterChainProcess(FilterChain *chain, int16_t *samples, uint32_t count) {
+    for (uint32_t i = 0; i < chain->count; i++) {
+        FilterStage *stage = &chain->stages[i];
+        uint32_t start = TimingNow();
+        switch (stage->type) {
+            case FILTER_FIR:
+                ProcessFir(&stage->fir, samples, count);
+                break;
+            case FILTER_BIQUAD:
+                ProcessBiquad(&stage->biquad, samples, count);
+                break;
+            case FILTER_MEDIAN:
+                ProcessMedian(&stage->median, samples, count);
+                break;
+            case FILTER_EMA:
+                ProcessEma(&stage->ema, samples, count);
+                break;
+        }
+        stage->cycles += TimingNow() - start;
+        stage->samples += count;
+    }
+}
+
+uint32_t FilterStageCyclesPer100(const FilterChain *chain, uint32_t index) {
+    const FilterStage *stage = &chain->stages[index];
+    return (stage->samples > 0) ? (uint32_t)((uint64_t)stage->cycles * 100 / stage->samples) : 0;
+}
+
+const char *FilterTypeName(FilterType type) {
+    static const char *const names[FILTER_TYPE_COUNT] = {"fir", "biquad", "median", "ema"};
+    return (type < FILTER_TYPE_COUNT) ? names[type] : "?";
+}
@@ -0,0 +1,100 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Cadeia de filtros em ponto fixo para o sinal do LDR, montada em tempo de execucao. As
+// amostras sao Q15 (int16) e passam por cada estagio em ordem, no proprio vetor. Os lacos
+// de FIR e biquad usam as instrucoes SIMD do Cortex-M4 (SMLAD/SMLALD em pares de 16 bits);
+// no host as mesmas operacoes sao feitas em C e host/filter_check.cpp confere bit a bit
+// contra a implementacao de referencia em host/filter_ref.cpp.
+//
+// Aritmetica de cada estagio (a referencia segue exatamente estas regras):
+//   FIR     y = sat16((sum c[k] * x[n-k] + 2^14) >> 15), c em Q15
+//   Biquad  y = sat16((b0 x0 + b1 x1 + b2 x2 - a1 y1 - a2 y2 + 2^13) >> 14), coeficientes Q14
+//   Mediana y = elemento (count - 1) / 2 das ultimas min(n, janela) amostras ordenadas
+//   EMA     s += (x * 2^16 - s) * alpha >> 15 com s em Q31 (a primeira amostra inicia s);
+//           y = sat16((s + 2^15) >> 16)
+#define FILTER_STAGES_MAX   6
+#define FILTER_FIR_TAPS_MAX 32      // Pares de coeficientes para o SMLAD
+#define FILTER_MEDIAN_MAX   15
+
+// Leitura de 12 bits do ADC (0 a 4095) em Q15 positivo e de volta
+#define FILTER_Q15_FROM_ADC(sample) ((int16_t)(((sample) & 0x0FFF) << 3))
+#define FILTER_ADC_FROM_Q15(q15)    ((uint16_t)(((q15) < 0) ? 0 : (q15) >> 3))
+
+typedef enum {
+    FILTER_FIR = 0,
+    FILTER_BIQUAD,
+    FILTER_MEDIAN,
+    FILTER_EMA,
+    FILTER_TYPE_COUNT
+} FilterType;
+
+typedef struct {
+    uint32_t taps;                                  // Arredondado para par
+    uint32_t pos;
+    int16_t coeffs[FILTER_FIR_TAPS_MAX];            // Invertidos: coeffs[j] multiplica a j-esima mais antiga
+    int16_t history[2 * FILTER_FIR_TAPS_MAX];       // Linha de atraso duplicada, janela sempre contigua
+} FilterFir;
+
+typedef struct {
+    int16_t b0, b1, b2;
+    int16_t na1, na2;       // -a1 e -a2: o laco so soma
+    int16_t x1, x2, y1, y2;
+} FilterBiquad;
+
+typedef struct {
+    uint32_t window;
+    uint32_t count;
+    uint32_t pos;
+    int16_t ring[FILTER_MEDIAN_MAX];    // Ordem de chegada
+    int16_t sorted[FILTER_MEDIAN_MAX];
+} FilterMedian;
+
+typedef struct {
+    int16_t alpha;          // Q15, 1 a 32767
+    bool primed;
+    int32_t state;          // Q31
+} FilterEma;
+
+typedef struct {
+    uint8_t type;           // FilterType
+    union {
+        FilterFir fir;
+        FilterBiquad biquad;
+        FilterMedian median;
+        FilterEma ema;
+    };
+    uint32_t samples;       // Amostras processadas e ciclos gastos, para ciclos por amostra
+    uint32_t cycles;
+} FilterStage;
+
+typedef struct {
+    FilterStage stages[FILTER_STAGES_MAX];
+    uint32_t count;
+} FilterChain;
+
+void FilterChainInit(FilterChain *chain);
+
+// Acrescentam um estagio no fim; falham com a cadeia cheia ou parametros fora da faixa.
+// O FIR exige sum |c| <= 32768 (ganho ate 1), o que garante que o acumulador de 32 bits
+// do SMLAD nao transborda.
+bool FilterChainAddFir(FilterChain *chain, const int16_t *coeffs, uint32_t taps);
+bool FilterChainAddBiquad(FilterChain *chain, const int16_t coeffs[5]);    // b0 b1 b2 a1 a2 (a0 = 1)
+bool FilterChainAddMedian(FilterChain *chain, uint32_t window);
+bool FilterChainAddEma(FilterChain *chain, int16_t alpha);
+
+// Zera o estado de todos os estagios (historico, mediana, EMA) e as contagens
+void FilterChainReset(FilterChain *chain);
+// So as contagens de ciclos, para medir por periodos sem perder o estado dos filtros
+void FilterChainResetStats(FilterChain *chain);
+
+void FilterChainProcess(FilterChain *chain, int16_t *samples, uint32_t count);
+
+// Ciclos por 100 amostras do estagio index desde o ultimo reset (0 sem amostras)
+uint32_t FilterStageCyclesPer100(const FilterChain *chain, uint32_t index);
+const char *FilterTypeName(FilterType type);
+
+#endif // FILTER_H
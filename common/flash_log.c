@@ -0,0 +1,252 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "flash_log.h"
+
+#if defined(__arm__)
+#include "driverlib/flash.h"
+#else
+#include <stdio.h>
+#endif
+
+#define REGION_SIZE     (FLASH_LOG_SECTORS * FLASH_LOG_SECTOR_SIZE)
+#define ERASED_WORD     0xFFFFFFFFu
+
+static uint32_t logSector = FLASH_LOG_SECTORS - 1;     // Setor de escrita; o primeiro aberto e o 0
+static uint32_t logOffset;                              // Proxima posicao livre dentro dele
+static uint32_t logSequence;
+static bool logOpen;                                    // Ha algum setor com cabecalho valido
+static uint32_t logErasePending;                        // Setores que faltam no FlashLogEraseStep
+static uint32_t logStaging[FLASH_LOG_RECORD_MAX / 4];   // Registro montado em palavras
+static FlashLogStats logStats;
+
+#if defined(__arm__)
+static const uint8_t *Region(void) {
+    return (const uint8_t *)FLASH_LOG_BASE;
+}
+
+static bool EraseSector(uint32_t sector) {
+    return FlashErase(FLASH_LOG_BASE + sector * FLASH_LOG_SECTOR_SIZE) == 0;
+}
+
+static bool Program(uint32_t offset, uint32_t *words, uint32_t bytes) {
+    return FlashProgram(words, FLASH_LOG_BASE + offset, bytes) == 0;
+}
+#else
+static uint8_t logImage[REGION_SIZE];
+static FILE *logFile;
+
+static const uint8_t *Region(void) {
+    return logImage;
+}
+
+static void WriteThrough(uint32_t offset, uint32_t bytes) {
+    if (logFile == NULL)
+        return;
+    fseek(logFile, (long)offset, SEEK_SET);
+    fwrite(logImage + offset, 1, bytes, logFile);
+    fflush(logFile);
+}
+
+static bool EraseSector(uint32_t sector) {
+    memset(logImage + sector * FLASH_LOG_SECTOR_SIZE, 0xFF, FLASH_LOG_SECTOR_SIZE);
+    WriteThrough(sector * FLASH_LOG_SECTOR_SIZE, FLASH_LOG_SECTOR_SIZE);
+    return true;
+}
+
+// Como na flash, gravar so derruba bits de 1 para 0
+static bool Program(uint32_t offset, uint32_t *words, uint32_t bytes) {
+    const uint8_t *data = (const uint8_t *)words;
+    for (uint32_t i = 0; i < bytes; i++)
+        logImage[offset + i] &= data[i];
+    WriteThrough(offset, bytes);
+    return true;
+}
+
+bool FlashLogOpenFile(const char *path) {
+    if (logFile != NULL)
+        fclose(logFile);
+    memset(logImage, 0xFF, sizeof(logImage));
+    logFile = fopen(path, "r+b");
+    if (logFile != NULL) {
+        size_t got = fread(logImage, 1, sizeof(logImage), logFile);
+        (void)got;      // Arquivo curto: o resto fica apagado
+    } else if ((logFile = fopen(path, "w+b")) != NULL) {
+        WriteThrough(0, REGION_SIZE);
+    } else {
+        return false;
+    }
+    FlashLogInit();
+    return true;
+}
+#endif
+
+static uint32_t Word(uint32_t offset) {
+    uint32_t word;
+    memcpy(&word, Region() + offset, sizeof(word));
+    return word;
+}
+
+static bool ValidHeader(uint32_t header) {
+    return (header >> 24) == FLASH_LOG_RECORD_MAGIC && (header & 0xFFFF) <= FLASH_LOG_PAYLOAD_MAX;
+}
+
+static uint32_t RecordSize(uint32_t header) {
+    return 8 + (((header & 0xFFFF) + 3) & ~3u);
+}
+
+static bool SectorValid(uint32_t sector) {
+    return Word(sector * FLASH_LOG_SECTOR_SIZE) == FLASH_LOG_SECTOR_MAGIC;
+}
+
+// Fim dos registros de um setor valido. Um cabecalho corrompido (reset no meio de uma
+// gravacao) fecha o setor: o proximo registro ja vai para o setor seguinte.
+static uint32_t SectorEnd(uint32_t sector) {
+    uint32_t base = sector * FLASH_LOG_SECTOR_SIZE;
+    uint32_t offset = 8;
+    while (offset + 8 <= FLASH_LOG_SECTOR_SIZE) {
+        uint32_t header = Word(base + offset);
+        if (header == ERASED_WORD)
+            return offset;
+        if (!ValidHeader(header))
+            return FLASH_LOG_SECTOR_SIZE;
+        offset += RecordSize(header);
+    }
+    return offset;
+}
+
+// Apaga o setor seguinte ao atual e abre nele a proxima sequencia
+static bool OpenNextSector(void) {
+    uint32_t sector = (logSector + 1) % FLASH_LOG_SECTORS;
+    if (SectorValid(sector))
+        logStats.usedBytes -= SectorEnd(sector);
+    logStats.erases++;
+    if (!EraseSector(sector)) {
+        logStats.failures++;
+        return false;
+    }
+    uint32_t header[2] = {FLASH_LOG_SECTOR_MAGIC, logSequence + 1};
+    if (!Program(sector * FLASH_LOG_SECTOR_SIZE, header, sizeof(header))) {
+        logStats.failures++;
+        return false;
+    }
+    logSector = sector;
+    logSequence++;
+    logOffset = 8;
+    logOpen = true;
+    logStats.usedBytes += 8;
+    return true;
+}
+
+void FlashLogInit(void) {
+    logOpen = false;
+    logStats = (FlashLogStats){0};
+    for (uint32_t sector = 0; sector < FLASH_LOG_SECTORS; sector++) {
+        if (!SectorValid(sector))
+            continue;
+        uint32_t sequence = Word(sector * FLASH_LOG_SECTOR_SIZE + 4);
+        if (!logOpen || (int32_t)(sequence - logSequence) > 0) {
+            logSector = sector;
+            logSequence = sequence;
+            logOpen = true;
+        }
+        logStats.usedBytes += SectorEnd(sector);
+    }
+    logOffset = logOpen ? SectorEnd(logSector) : FLASH_LOG_SECTOR_SIZE;
+}
+
+bool FlashLogAppend(uint8_t tag, uint32_t time, const void *payload, uint32_t length) {
+    if (length > FLASH_LOG_PAYLOAD_MAX)
+        return false;
+    uint32_t size = 8 + ((length + 3) & ~3u);
+    if ((!logOpen || logOffset + size > FLASH_LOG_SECTOR_SIZE) && !OpenNextSector())
+        return false;
+
+    logStaging[1 + (size - 8) / 4] = 0;     // Completa a ultima palavra do payload
+    logStaging[0] = (FLASH_LOG_RECORD_MAGIC << 24) | ((uint32_t)tag << 16) | length;
+    logStaging[1] = time;
+    memcpy(&logStaging[2], payload, length);
+    if (!Program(logSector * FLASH_LOG_SECTOR_SIZE + logOffset, logStaging, size)) {
+        logStats.failures++;
+        logOffset = FLASH_LOG_SECTOR_SIZE;  // Nao grava de novo por cima do que ficou pela metade
+        return false;
+    }
+    logOffset += size;
+    logStats.records++;
+    logStats.usedBytes += size;
+    return true;
+}
+
+bool FlashLogBlockAdd(FlashLogBlock *block, uint8_t tag, uint16_t sample, uint32_t time) {
+    if (block->count == 0)
+        block->time = time;
+    block->samples[block->count++] = sample;
+    if (block->count < FLASH_LOG_BLOCK_SAMPLES)
+        return false;
+    return FlashLogBlockFlush(block, tag);
+}
+
+bool FlashLogBlockFlush(FlashLogBlock *block, uint8_t tag) {
+    uint32_t count = block->count;
+    block->count = 0;
+    return count > 0 && FlashLogAppend(tag, block->time, block->samples, count * sizeof(uint16_t));
+}
+
+void FlashLogErase(void) {
+    while (!FlashLogEraseStep());
+}
+
+bool FlashLogEraseStep(void) {
+    if (logErasePending == 0) {
+        logErasePending = FLASH_LOG_SECTORS;
+        logOpen = false;
+        logOffset = FLASH_LOG_SECTOR_SIZE;
+        logStats.usedBytes = 0;
+    }
+    logStats.erases++;
+    if (!EraseSector(FLASH_LOG_SECTORS - logErasePending))
+        logStats.failures++;
+    return --logErasePending == 0;
+}
+
+void FlashLogRewind(FlashLogCursor *cursor) {
+    cursor->sector = logSector;
+    cursor->offset = FLASH_LOG_SECTOR_SIZE;
+    cursor->remaining = 0;
+    if (!logOpen)
+        return;
+    // O mais antigo e o primeiro setor valido depois do atual, na ordem do anel
+    for (uint32_t k = 1; k <= FLASH_LOG_SECTORS; k++) {
+        uint32_t sector = (logSector + k) % FLASH_LOG_SECTORS;
+        if (SectorValid(sector)) {
+            cursor->sector = sector;
+            cursor->offset = 8;
+            cursor->remaining = (logSector + FLASH_LOG_SECTORS - sector) % FLASH_LOG_SECTORS;
+            return;
+        }
+    }
+}
+
+uint32_t FlashLogNext(FlashLogCursor *cursor, const uint8_t **record) {
+    while (true) {
+        uint32_t base = cursor->sector * FLASH_LOG_SECTOR_SIZE;
+        if (cursor->offset + 8 <= FLASH_LOG_SECTOR_SIZE) {
+            uint32_t header = Word(base + cursor->offset);
+            if (header != ERASED_WORD && ValidHeader(header)) {
+                *record = Region() + base + cursor->offset;
+                cursor->offset += RecordSize(header);
+                return 8 + (header & 0xFFFF);
+            }
+        }
+        if (cursor->remaining == 0)
+            return 0;
+        cursor->remaining--;
+        cursor->sector = (cursor->sector + 1) % FLASH_LOG_SECTORS;
+        cursor->offset = 8;
+    }
+}
+
+void FlashLogGetStats(FlashLogStats *stats) {
+    *stats = logStats;
+    stats->sequence = logSequence;
+}
@@ -0,0 +1,84 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Log circular de registros binarios com carimbo de tempo nos ultimos 64 KB da flash interna,
+// para capturar rajadas de amostras acima do que a UART leva ao vivo e buscar depois.
+// A regiao e um anel de setores de apagamento: quando o setor atual enche, o seguinte (o
+// mais antigo) e apagado e recebe um cabecalho com o proximo numero de sequencia. Cada setor
+// e apagado uma vez por volta do anel, entao o desgaste se espalha igualmente.
+// Cada registro e gravado numa unica chamada ao FlashProgram, em palavras inteiras: o maior
+// registro tem 32 palavras, o tamanho do buffer de escrita da flash.
+//
+// Setor:    [FLASH_LOG_SECTOR_MAGIC][sequencia][registros...][0xFFFFFFFF...]
+// Registro: [0xA5 << 24 | tag << 16 | tamanho do payload][tempo][payload completado ate a palavra]
+//
+// Gravar para a CPU enquanto a flash esta ocupada (apagar um setor leva alguns ms): chame de
+// uma thread ou do laco principal, nunca de ISR. O modulo nao tem trava: todas as chamadas,
+// inclusive a leitura com o cursor, devem vir da mesma thread, ou a aplicacao garante que
+// nada grava nem apaga enquanto um cursor esta em uso (FlashLogNext devolve ponteiros para
+// a propria flash, que um apagamento invalida). No host (sem __arm__) a regiao e uma imagem
+// em RAM espelhada num arquivo (FlashLogOpenFile), com a mesma semantica de apagar e gravar.
+#define FLASH_LOG_BASE          0x000F0000  // Ultimos 64 KB da flash de 1 MB
+#define FLASH_LOG_SECTOR_SIZE   0x4000      // Setor de apagamento do TM4C1294
+#define FLASH_LOG_SECTORS       4
+#define FLASH_LOG_SECTOR_MAGIC  0x31474F4Cu // "LOG1"
+#define FLASH_LOG_RECORD_MAGIC  0xA5u
+#define FLASH_LOG_PAYLOAD_MAX   120         // Registro de 128 bytes (32 palavras)
+#define FLASH_LOG_RECORD_MAX    (8 + FLASH_LOG_PAYLOAD_MAX)
+
+// Bloco de amostras de 16 bits montado em RAM e gravado quando enche
+#define FLASH_LOG_BLOCK_SAMPLES (FLASH_LOG_PAYLOAD_MAX / 2)
+
+typedef struct {
+    uint32_t time;          // Tempo da primeira amostra
+    uint32_t count;
+    uint16_t samples[FLASH_LOG_BLOCK_SAMPLES];
+} FlashLogBlock;
+
+typedef struct {
+    uint32_t records;       // Registros gravados desde o boot
+    uint32_t erases;        // Setores apagados desde o boot
+    uint32_t failures;      // Erros do FlashErase/FlashProgram
+    uint32_t usedBytes;     // Bytes ocupados na regiao (cabecalhos incluidos)
+    uint32_t sequence;      // Sequencia do setor atual
+} FlashLogStats;
+
+// Leitura do mais antigo ao mais novo, direto da flash (sem copia)
+typedef struct {
+    uint32_t sector;
+    uint32_t offset;
+    uint32_t remaining;     // Setores que ainda faltam depois do atual
+} FlashLogCursor;
+
+// Procura o setor mais novo e a posicao de escrita; dados de antes do reset continuam no log
+void FlashLogInit(void);
+
+// Grava um registro; false se length > FLASH_LOG_PAYLOAD_MAX ou a flash falhar
+bool FlashLogAppend(uint8_t tag, uint32_t time, const void *payload, uint32_t length);
+
+// Acrescenta uma amostra ao bloco e grava o bloco quando enche (true quando gravou)
+bool FlashLogBlockAdd(FlashLogBlock *block, uint8_t tag, uint16_t sample, uint32_t time);
+// Grava o que houver no bloco (fim de captura)
+bool FlashLogBlockFlush(FlashLogBlock *block, uint8_t tag);
+
+// Apaga a regiao inteira
+void FlashLogErase(void);
+// O mesmo, um setor por chamada, para limitar cada parada da CPU a um apagamento; devolve
+// true quando terminou. O log fica vazio desde a primeira chamada; nao grave ate terminar.
+bool FlashLogEraseStep(void);
+
+void FlashLogRewind(FlashLogCursor *cursor);
+// Proximo registro (cabecalho, tempo e payload); devolve o tamanho em bytes ou 0 no fim
+uint32_t FlashLogNext(FlashLogCursor *cursor, const uint8_t **record);
+
+void FlashLogGetStats(FlashLogStats *stats);
+
+#if !defined(__arm__)
+// Abre (ou cria apagado) o arquivo que faz o papel da regiao e chama FlashLogInit
+bool FlashLogOpenFile(const char *path);
+#endif
+
+#endif // FLASH_LOG_H
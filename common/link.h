@@ -0,0 +1,37 @@
+#ifndef LINK_H
+#define LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Camada de enlace da UART0: cada mensagem vira um quadro COBS terminado em 0x00 com
+// [canal][payload][CRC-16/CCITT-FALSE do canal e do payload, little-endian]. Um byte
+// corrompido derruba so o quadro dele; o receptor ressincroniza no proximo 0x00.
+// O lado do PC fica em host/link.hpp (demultiplexa os canais e confere o CRC).
+typedef enum {
+    LINK_CH_CONTROL = 0,    // Texto: respostas de comandos e mensagens para o usuario
+    LINK_CH_TELEMETRY,      // Registros binarios de sensores
+    LINK_CH_RESULTS,        // Registros binarios de resultados (ResponseData no projeto raiz)
+    LINK_CH_LOGS,           // Registros do log adiado (common/dlog.h)
+    LINK_CH_CAPTURE,        // Registros do log em flash (common/flash_log.h); vazio = fim do dump
+    LINK_CH_COUNT
+} LinkChannel;
+
+#define LINK_PAYLOAD_MAX    250     // Maior payload aceito pelo receptor
+#define LINK_SEND_MAX       64      // Maior payload de LinkSend (quadro montado na pilha)
+
+// Pior caso do quadro: canal + CRC, um byte de codigo a cada 254 e o delimitador
+#define LINK_FRAME_MAX(length)  ((length) + 3 + ((length) + 3) / 254 + 1 + 1)
+
+#define LINK_CRC_INIT       0xFFFF
+
+uint16_t LinkCrc16(uint16_t crc, const uint8_t *data, uint32_t length);
+
+// Monta o quadro em frame (LINK_FRAME_MAX(length) bytes) e devolve o tamanho
+uint32_t LinkEncode(uint8_t channel, const void *payload, uint32_t length, uint8_t *frame);
+
+// Poe o quadro inteiro no buffer de TX (common/uart_tx.h), ou nada: devolve false se nao
+// couber agora ou se length > LINK_SEND_MAX. Segue as regras de produtor do UartTxWrite.
+bool LinkSend(uint8_t channel, const void *payload, uint32_t length);
+
+#endif // LINK_H
@@ -0,0 +1,126 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "TM4C129.h"
+#include "cmsis_os2.h"
+#include "timing.h"
+#include "msg_queue.h"
+
+static void AtomicIncrement(volatile uint32_t *counter) {
+    uint32_t value;
+    do {
+        value = __LDREXW(counter) + 1;
+    } while (__STREXW(value, counter));
+}
+
+static void AtomicMax(volatile uint32_t *target, uint32_t value) {
+    uint32_t current;
+    do {
+        current = __LDREXW(target);
+        if (value <= current) {
+            __CLREX();
+            return;
+        }
+    } while (__STREXW(value, target));
+}
+
+// Faixa de potencia de 4 a partir de 256 ciclos, pelo numero de bits significativos
+static uint32_t WaitBucket(uint32_t cycles) {
+    uint32_t bits = 32 - __CLZ(cycles);
+    uint32_t bucket = (bits <= 8) ? 0 : (bits - 7) / 2;
+    return (bucket < MSGQ_HIST_BUCKETS) ? bucket : MSGQ_HIST_BUCKETS - 1;
+}
+
+// Timeout 0 devolve osErrorResource; com espera, osErrorTimeout
+static bool GaveUp(osStatus_t status) {
+    return status == osErrorTimeout || status == osErrorResource;
+}
+
+bool MsgQueueInit(MsgQueue *queue, const char *name, uint32_t capacity, uint32_t msgSize, MsgQueuePolicy policy) {
+    const osMessageQueueAttr_t attr = {.name = name};
+    *queue = (MsgQueue){.name = name, .policy = policy, .capacity = capacity, .msgSize = msgSize};
+    if (policy >= MSGQ_POLICY_COUNT || ((policy == MSGQ_DROP_OLDEST || policy == MSGQ_COALESCE_LATEST) && msgSize > MSGQ_MSG_MAX))
+        return false;
+    queue->id = osMessageQueueNew(capacity, msgSize, &attr);
+    return queue->id != NULL;
+}
+
+osStatus_t MsgQueuePut(MsgQueue *queue, const void *msg, uint32_t timeout) {
+    uint32_t discard[(MSGQ_MSG_MAX + 3) / 4];
+    osStatus_t status = osErrorParameter;
+    uint32_t start = TimingNow();
+
+    switch (queue->policy) {
+        case MSGQ_BLOCK:
+            status = osMessageQueuePut(queue->id, msg, 0, timeout);
+            break;
+        case MSGQ_DROP_NEWEST:
+            status = osMessageQueuePut(queue->id, msg, 0, 0);
+            if (status == osErrorResource)
+                AtomicIncrement(&queue->drops);
+            break;
+        case MSGQ_COALESCE_LATEST:
+            // O consumidor ainda nao pegou as anteriores: ficam obsoletas
+            while (osMessageQueueGet(queue->id, discard, NULL, 0) == osOK)
+                AtomicIncrement(&queue->drops);
+            // Fall through: outro produtor pode ter enchido a fila nesse meio tempo
+        case MSGQ_DROP_OLDEST:
+            // Se o consumidor esvaziar a fila entre as tentativas, o put seguinte entra
+            while ((status = osMessageQueuePut(queue->id, msg, 0, 0)) == osErrorResource) {
+                if (osMessageQueueGet(queue->id, discard, NULL, 0) == osOK)
+                    AtomicIncrement(&queue->drops);
+            }
+            break;
+        default:
+            break;
+    }
+    if (status == osOK) {
+        AtomicIncrement(&queue->puts);
+        AtomicMax(&queue->highWater, osMessageQueueGetCount(queue->id));
+    } else if (GaveUp(status) && queue->policy == MSGQ_BLOCK) {
+        AtomicIncrement(&queue->putTimeouts);   // Nas outras politicas fila cheia e descarte
+    }
+    AtomicIncrement(&queue->putWait[WaitBucket(TimingNow() - start)]);
+    return status;
+}
+
+osStatus_t MsgQueueGet(MsgQueue *queue, void *msg, uint32_t timeout) {
+    uint32_t start = TimingNow();
+    osStatus_t status = osMessageQueueGet(queue->id, msg, NULL, timeout);
+    if (status == osOK) {
+        AtomicIncrement(&queue->gets);
+    } else if (GaveUp(status)) {
+        AtomicIncrement(&queue->getTimeouts);
+    }
+    AtomicIncrement(&queue->getWait[WaitBucket(TimingNow() - start)]);
+    return status;
+}
+
+uint32_t MsgQueueCount(const MsgQueue *queue) {
+    return osMessageQueueGetCount(queue->id);
+}
+
+void MsgQueueGetStats(const MsgQueue *queue, MsgQueueStats *stats) {
+    stats->puts = queue->puts;
+    stats->gets = queue->gets;
+    stats->drops = queue->drops;
+    stats->putTimeouts = queue->putTimeouts;
+    stats->getTimeouts = queue->getTimeouts;
+    stats->highWater = queue->highWater;
+    stats->capacity = queue->capacity;
+    stats->memBytes = MSGQ_RTX_MEM_SIZE(queue->capacity, queue->msgSize);
+    stats->policy = queue->policy;
+    for (uint32_t b = 0; b < MSGQ_HIST_BUCKETS; b++) {
+        stats->putWait[b] = queue->putWait[b];
+        stats->getWait[b] = queue->getWait[b];
+    }
+}
+
+const char *MsgQueuePolicyName(MsgQueuePolicy policy) {
+    static const char *const names[MSGQ_POLICY_COUNT] = {"block", "drop-newest", "drop-oldest", "coalesce-latest"};
+    return (policy < MSGQ_POLICY_COUNT) ? names[policy] : "?";
+}
+
+const char *MsgQueueBucketName(uint32_t bucket) {
+    static const char *const names[MSGQ_HIST_BUCKETS] = {"<256", "<1k", "<4k", "<16k", "<64k", "<256k", "<1M", ">=1M"};
+    return (bucket < MSGQ_HIST_BUCKETS) ? names[bucket] : "?";
+}
@@ -0,0 +1,76 @@
+#ifndef MSG_QUEUE_H
+#define MSG_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cmsis_os2.h"
+
+// Fila de mensagens do CMSIS-RTOS2 com politica de sobrecarga escolhida por fila e
+// instrumentada: descartes, pico de ocupacao, timeouts e histogramas do tempo gasto em put
+// e get (em ciclos, common/timing.h). A politica diz quem cede quando a fila enche: quem
+// produz (BLOCK) ou as mensagens (as outras). Os numeros servem para dimensionar a
+// capacidade de cada fila e o OS_DYNAMIC_MEM_SIZE do RTX.
+typedef enum {
+    MSGQ_BLOCK = 0,         // Put espera por espaco ate o timeout do chamador
+    MSGQ_DROP_NEWEST,       // Fila cheia: a mensagem nova e descartada
+    MSGQ_DROP_OLDEST,       // Fila cheia: a mais antiga sai para a nova entrar
+    MSGQ_COALESCE_LATEST,   // So a ultima vale: a nova substitui as que ainda esperam
+    MSGQ_POLICY_COUNT
+} MsgQueuePolicy;
+
+#define MSGQ_MSG_MAX    96      // Maior mensagem em DROP_OLDEST/COALESCE_LATEST (descarte na pilha)
+
+// Histograma de espera em faixas de potencia de 4: <256, <1k, <4k, <16k, <64k, <256k, <1M e
+// >= 1M ciclos
+#define MSGQ_HIST_BUCKETS   8
+
+// Memoria que o RTX5 tira do OS_DYNAMIC_MEM_SIZE para uma fila sem memoria propria: bloco
+// de controle (52 bytes) e osRtxMessageQueueMemSize, cada um com o cabecalho de 8 bytes
+// do alocador
+#define MSGQ_RTX_MEM_SIZE(count, size)  (52 + 8 + 4 * (count) * (3 + ((size) + 3) / 4) + 8)
+
+typedef struct {
+    uint32_t puts;          // Mensagens aceitas
+    uint32_t gets;
+    uint32_t drops;         // Descartadas pela politica (novas ou antigas)
+    uint32_t putTimeouts;   // Put ou get que desistiu (osErrorTimeout, ou fila cheia/vazia com timeout 0)
+    uint32_t getTimeouts;
+    uint32_t highWater;     // Maior ocupacao vista logo apos um put
+    uint32_t capacity;
+    uint32_t memBytes;      // MSGQ_RTX_MEM_SIZE da fila
+    MsgQueuePolicy policy;
+    uint32_t putWait[MSGQ_HIST_BUCKETS];
+    uint32_t getWait[MSGQ_HIST_BUCKETS];
+} MsgQueueStats;
+
+typedef struct {
+    osMessageQueueId_t id;
+    const char *name;
+    MsgQueuePolicy policy;
+    uint32_t capacity;
+    uint32_t msgSize;
+    volatile uint32_t puts;
+    volatile uint32_t gets;
+    volatile uint32_t drops;
+    volatile uint32_t putTimeouts;
+    volatile uint32_t getTimeouts;
+    volatile uint32_t highWater;
+    volatile uint32_t putWait[MSGQ_HIST_BUCKETS];
+    volatile uint32_t getWait[MSGQ_HIST_BUCKETS];
+} MsgQueue;
+
+// Cria a fila; falha se o RTOS nao tiver memoria ou a mensagem for grande demais para a politica
+bool MsgQueueInit(MsgQueue *queue, const char *name, uint32_t capacity, uint32_t msgSize, MsgQueuePolicy policy);
+
+// timeout so vale para MSGQ_BLOCK (0 em ISR). DROP_NEWEST devolve osErrorResource quando
+// descarta; DROP_OLDEST e COALESCE_LATEST sempre enfileiram. Pode ser chamada de ISR.
+osStatus_t MsgQueuePut(MsgQueue *queue, const void *msg, uint32_t timeout);
+osStatus_t MsgQueueGet(MsgQueue *queue, void *msg, uint32_t timeout);
+uint32_t MsgQueueCount(const MsgQueue *queue);
+void MsgQueueGetStats(const MsgQueue *queue, MsgQueueStats *stats);
+const char *MsgQueuePolicyName(MsgQueuePolicy policy);
+
+// Rotulo da faixa do histograma ("<256" ... ">=1M")
+const char *MsgQueueBucketName(uint32_t bucket);
+
+#endif // MSG_QUEUE_H
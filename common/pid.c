@@ -0,0 +1,75 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid.h"
+
+bool PidInit(Pid *pid, const PidGainStep *schedule, uint32_t steps, int32_t outMin, int32_t outMax) {
+    if (steps == 0 || outMin >= outMax)
+        return false;
+    pid->schedule = schedule;
+    pid->steps = steps;
+    pid->outMin = outMin;
+    pid->outMax = outMax;
+    pid->stats = (PidStats){0};
+    PidSetSetpoint(pid, 0);
+    PidReset(pid, outMin);
+    return true;
+}
+
+void PidSetSetpoint(Pid *pid, int32_t setpoint) {
+    uint32_t step = 0;
+    while (step + 1 < pid->steps && setpoint > pid->schedule[step].upTo)
+        step++;
+    pid->setpoint = setpoint;
+    pid->gains = pid->schedule[step].gains;
+}
+
+void PidReset(Pid *pid, int32_t output) {
+    if (output < pid->outMin)
+        output = pid->outMin;
+    if (output > pid->outMax)
+        output = pid->outMax;
+    pid->integral = (int64_t)output << 16;
+    pid->output = output;
+    pid->primed = false;
+}
+
+int32_t PidUpdate(Pid *pid, int32_t measurement) {
+    const int64_t min = (int64_t)pid->outMin << 16;
+    const int64_t max = (int64_t)pid->outMax << 16;
+    int32_t error = pid->setpoint - measurement;
+    int32_t delta = pid->primed ? measurement - pid->last : 0;
+    pid->last = measurement;
+    pid->primed = true;
+    pid->stats.updates++;
+
+    int64_t pd = (int64_t)pid->gains.kp * error - (int64_t)pid->gains.kd * delta;
+    int64_t integral = pid->integral + (int64_t)pid->gains.ki * error;
+    int64_t out = pd + integral;
+
+    // Integracao condicional: com o erro empurrando a saida para alem do limite, o integrador
+    // so anda ate a saida encostar no limite (e nunca volta por causa disso)
+    if (out > max && error > 0) {
+        integral = (pid->integral > max - pd) ? pid->integral : max - pd;
+        out = pd + integral;
+        pid->stats.frozen++;
+    } else if (out < min && error < 0) {
+        integral = (pid->integral < min - pd) ? pid->integral : min - pd;
+        out = pd + integral;
+        pid->stats.frozen++;
+    }
+    if (integral > max)
+        integral = max;
+    else if (integral < min)
+        integral = min;
+    pid->integral = integral;
+
+    if (out > max) {
+        out = max;
+        pid->stats.saturated++;
+    } else if (out < min) {
+        out = min;
+        pid->stats.saturated++;
+    }
+    pid->output = (int32_t)((out + 0x8000) >> 16);
+    return pid->output;
+}
@@ -0,0 +1,66 @@
+#ifndef PID_H
+#define PID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// PID em ponto fixo para malhas rodadas numa interrupcao periodica. Os ganhos sao Q16 ja
+// convertidos para o periodo de amostragem (ki * Ts e kd / Ts), entao cada passo e so tres
+// multiplicacoes, somas e a saturacao, sem divisao nem ponto flutuante.
+//   u = kp e + I + kd (m[n-1] - m[n]),  I += ki e,  com e = setpoint - m
+// A derivada e sobre a medida (degrau no setpoint nao da chute). Anti-windup: o integrador
+// nao passa do ponto em que a saida satura no sentido do erro e fica sempre dentro da faixa
+// da saida. O integrador guarda o termo ja multiplicado por ki, entao uma troca de ki nao
+// mexe no termo integral; kp e kd valem na hora, e a saida pula (kp_novo - kp_antigo) * e.
+//
+// Tabela de ganhos: faixas de setpoint com ganhos proprios (a planta costuma ter ganho
+// diferente em cada ponto de operacao). A faixa e escolhida quando o setpoint muda, nunca
+// no passo do controle.
+#define PID_Q16(x)  ((int32_t)((x) * 65536.0 + (((x) < 0) ? -0.5 : 0.5)))
+
+// kp em unidades de saida por unidade de erro, ki em 1/s e kd em s, para amostras a rateHz
+#define PID_GAINS(kp, ki, kd, rateHz)   {PID_Q16(kp), PID_Q16((double)(ki) / (rateHz)), PID_Q16((double)(kd) * (rateHz))}
+
+typedef struct {
+    int32_t kp;             // Q16, por amostra
+    int32_t ki;
+    int32_t kd;
+} PidGains;
+
+// Vale para setpoints ate upTo (inclusive), em ordem crescente; a ultima cobre o resto
+typedef struct {
+    int32_t upTo;
+    PidGains gains;
+} PidGainStep;
+
+typedef struct {
+    uint32_t updates;
+    uint32_t saturated;     // Passos com a saida no limite
+    uint32_t frozen;        // Passos em que o anti-windup segurou o integrador
+} PidStats;
+
+typedef struct {
+    const PidGainStep *schedule;
+    uint32_t steps;
+    PidGains gains;         // Faixa do setpoint atual
+    int32_t setpoint;
+    int32_t outMin;
+    int32_t outMax;
+    int64_t integral;       // Q16, em unidades de saida
+    int32_t last;           // Medida anterior, para a derivada
+    bool primed;
+    int32_t output;
+    PidStats stats;
+} Pid;
+
+// A tabela nao e copiada e precisa de pelo menos uma faixa; outMin < outMax
+bool PidInit(Pid *pid, const PidGainStep *schedule, uint32_t steps, int32_t outMin, int32_t outMax);
+void PidSetSetpoint(Pid *pid, int32_t setpoint);
+
+// Recomeca a partir de output (transicao sem salto de malha aberta para fechada)
+void PidReset(Pid *pid, int32_t output);
+
+// Um passo do controle; devolve a saida ja saturada em [outMin, outMax]
+int32_t PidUpdate(Pid *pid, int32_t measurement);
+
+#endif // PID_H
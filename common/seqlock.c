@@ -0,0 +1,50 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "TM4C129.h"
+#include "seqlock.h"
+
+static void AtomicAdd(volatile uint32_t *counter, uint32_t amount) {
+    uint32_t value;
+    do {
+        value = __LDREXW(counter) + amount;
+    } while (__STREXW(value, counter));
+}
+
+void SeqlockInit(Seqlock *lock, void *copies, uint32_t size) {
+    lock->sequence = 0;
+    lock->retries = 0;
+    lock->publishes = 0;
+    lock->size = size;
+    lock->copies = copies;
+    memset(copies, 0, 2 * size);
+}
+
+// Sequencia impar: o escritor esta na copia 0 e a copia 1 vale. Par: o contrario.
+void SeqlockPublish(Seqlock *lock, const void *value) {
+    lock->sequence++;
+    __DMB();
+    memcpy(lock->copies, value, lock->size);
+    __DMB();
+    lock->sequence++;
+    __DMB();
+    memcpy(lock->copies + lock->size, value, lock->size);
+    lock->publishes++;
+}
+
+uint32_t SeqlockRead(Seqlock *lock, void *value) {
+    uint32_t retries = 0;
+    uint32_t sequence;
+    while (true) {
+        sequence = lock->sequence;
+        __DMB();
+        memcpy(value, lock->copies + ((sequence & 1) ? lock->size : 0), lock->size);
+        __DMB();
+        if (lock->sequence == sequence)
+            break;
+        retries++;
+    }
+    if (retries > 0)
+        AtomicAdd(&lock->retries, retries);
+    return retries;
+}
@@ -0,0 +1,30 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Publicacao de um valor de um escritor para varios leitores sem trava (seqlock com duas
+// copias). O escritor atualiza uma copia de cada vez e avanca o contador de sequencia entre
+// elas, entao nunca espera ninguem. O leitor escolhe a copia que o escritor nao esta tocando
+// pelo bit 0 da sequencia e so refaz a leitura se o escritor terminou uma etapa no meio dela.
+// Ao contrario do seqlock de uma copia, um leitor de prioridade maior que preempta o escritor
+// no meio da escrita nao fica girando: a outra copia ja esta completa.
+typedef struct {
+    volatile uint32_t sequence;
+    volatile uint32_t retries;  // Leituras refeitas, somadas de todos os leitores
+    uint32_t publishes;
+    uint32_t size;
+    uint8_t *copies;            // Duas copias de size bytes
+} Seqlock;
+
+// copies: 2 * size bytes, zerados aqui (o leitor ve zeros ate a primeira publicacao)
+void SeqlockInit(Seqlock *lock, void *copies, uint32_t size);
+
+// So um escritor por Seqlock; nao bloqueia
+void SeqlockPublish(Seqlock *lock, const void *value);
+
+// Qualquer thread; devolve quantas vezes a copia teve de ser relida
+uint32_t SeqlockRead(Seqlock *lock, void *value);
+
+#endif // SEQLOCK_H
@@ -0,0 +1,81 @@
+#if !defined(__arm__)
+#define _POSIX_C_SOURCE 199309L     // clock_gettime no build de host
+#endif
+
+#include <stdint.h>
+#include "timing.h"
+
+#if defined(__arm__)
+#include "TM4C129.h"
+#else
+#include <time.h>
+#endif
+
+static uint32_t timingHz = 1000000000u;
+
+void TimingInit(uint32_t clockHz) {
+#if defined(__arm__)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    timingHz = clockHz;
+#else
+    (void)clockHz;      // No host, um "ciclo" e um nanossegundo
+#endif
+}
+
+uint32_t TimingNow(void) {
+#if defined(__arm__)
+    return DWT->CYCCNT;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+uint32_t TimingFrequency(void) {
+    return timingHz;
+}
+
+float TimingCyclesToMicroseconds(uint32_t cycles) {
+    return (float)cycles * (1000000.0f / (float)timingHz);
+}
+
+void TimingSamplesReset(TimingSamples *set) {
+    set->count = 0;
+}
+
+void TimingSamplesAdd(TimingSamples *set, uint32_t cycles) {
+    if (set->count < TIMING_MAX_SAMPLES)
+        set->samples[set->count++] = cycles;
+}
+
+// Ordena as amostras no lugar (insertion sort: no maximo TIMING_MAX_SAMPLES elementos)
+void TimingSummarize(TimingSamples *set, TimingSummary *summary) {
+    uint32_t n = set->count;
+    uint64_t sum = 0;
+    summary->count = n;
+    if (n == 0) {
+        summary->min = summary->mean = summary->max = summary->p50 = summary->p99 = 0;
+        return;
+    }
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t value = set->samples[i];
+        uint32_t j = i;
+        while (j > 0 && set->samples[j - 1] > value) {
+            set->samples[j] = set->samples[j - 1];
+            j--;
+        }
+        set->samples[j] = value;
+    }
+    for (uint32_t i = 0; i < n; i++)
+        sum += set->samples[i];
+
+    // Percentis pelo metodo nearest-rank
+    summary->min = set->samples[0];
+    summary->max = set->samples[n - 1];
+    summary->mean = (uint32_t)(sum / n);
+    summary->p50 = set->samples[(n * 50 + 99) / 100 - 1];
+    summary->p99 = set->samples[(n * 99 + 99) / 100 - 1];
+}
@@ -0,0 +1,33 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+
+// Contador de ciclos: DWT CYCCNT no alvo, clock_gettime (ns) no host
+void TimingInit(uint32_t clockHz);
+uint32_t TimingNow(void);
+uint32_t TimingFrequency(void);
+float TimingCyclesToMicroseconds(uint32_t cycles);
+
+// Agrega as repeticoes de uma medida em min/media/max/p50/p99
+#define TIMING_MAX_SAMPLES  16
+
+typedef struct {
+    uint32_t samples[TIMING_MAX_SAMPLES];
+    uint32_t count;
+} TimingSamples;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t mean;
+    uint32_t max;
+    uint32_t p50;
+    uint32_t p99;
+} TimingSummary;
+
+void TimingSamplesReset(TimingSamples *set);
+void TimingSamplesAdd(TimingSamples *set, uint32_t cycles);
+void TimingSummarize(TimingSamples *set, TimingSummary *summary);
+
+#endif // TIMING_H
@@ -0,0 +1,89 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "TM4C129.h"
+#include "driverlib/uart.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+
+#define UART_RX_RING_MASK   (UART_RX_RING_SIZE - 1)
+
+// So a ISR escreve rxHead e so o consumidor escreve rxTail
+static char rxRing[UART_RX_RING_SIZE];
+static volatile uint32_t rxHead;
+static volatile uint32_t rxTail;
+static uint32_t rxReceived;
+static uint32_t rxOverruns;
+static uint32_t rxBase;
+static UartRxNotify rxNotify;
+
+void UartRxInit(uint32_t base, UartRxNotify notify) {
+    rxBase = base;
+    rxNotify = notify;
+    rxHead = rxTail = 0;
+
+    // Uma interrupcao a cada 8 bytes; o timeout RT entrega o resto de uma linha curta
+    UARTFIFOLevelSet(base, UART_TX_FIFO_LEVEL, UART_FIFO_RX4_8);
+    UARTFIFOEnable(base);
+    UARTIntEnable(base, UART_INT_RX | UART_INT_RT);
+}
+
+void UartRxIntHandler(void) {
+    uint32_t head = rxHead;
+    uint32_t tail = rxTail;
+    bool notify = false;
+    while (UARTCharsAvail(rxBase)) {
+        char c = (char)UARTCharGetNonBlocking(rxBase);
+        if (head - tail == UART_RX_RING_SIZE) {
+            rxOverruns++;
+            continue;
+        }
+        rxRing[head++ & UART_RX_RING_MASK] = c;
+        rxReceived++;
+        if (c == '\r' || c == '\n')
+            notify = true;
+    }
+    __DMB();
+    rxHead = head;
+    if (rxNotify && (notify || head - tail >= UART_RX_RING_SIZE / 2))
+        rxNotify();
+}
+
+uint32_t UartRxPeek(const char **data) {
+    uint32_t tail = rxTail;
+    uint32_t available = rxHead - tail;
+    uint32_t contiguous = UART_RX_RING_SIZE - (tail & UART_RX_RING_MASK);
+    __DMB();
+    *data = &rxRing[tail & UART_RX_RING_MASK];
+    return (available < contiguous) ? available : contiguous;
+}
+
+void UartRxConsume(uint32_t count) {
+    __DMB();
+    rxTail += count;
+}
+
+uint32_t UartRxRead(char *data, uint32_t max) {
+    uint32_t total = 0;
+    while (total < max) {
+        const char *slice;
+        uint32_t length = UartRxPeek(&slice);
+        if (length == 0)
+            break;
+        if (length > max - total)
+            length = max - total;
+        for (uint32_t i = 0; i < length; i++)
+            data[total + i] = slice[i];
+        UartRxConsume(length);
+        total += length;
+    }
+    return total;
+}
+
+uint32_t UartRxAvailable(void) {
+    return rxHead - rxTail;
+}
+
+void UartRxGetStats(UartRxStats *stats) {
+    stats->received = rxReceived;
+    stats->overruns = rxOverruns;
+}
@@ -0,0 +1,31 @@
+#ifndef UART_RX_H
+#define UART_RX_H
+
+#include <stdint.h>
+
+// Recepcao da UART por interrupcao: a ISR (RX por nivel e timeout RT) esvazia a FIFO de RX
+// num buffer circular SPSC; uma thread ou o laco principal consome os bytes.
+#ifndef UART_RX_RING_SIZE
+#define UART_RX_RING_SIZE   256     // Potencia de 2
+#endif
+
+typedef struct {
+    uint32_t received;      // Bytes guardados no buffer
+    uint32_t overruns;      // Bytes perdidos com o buffer cheio
+} UartRxStats;
+
+// Chamada pela ISR ao receber um fim de linha ou quando o buffer passa da metade
+typedef void (*UartRxNotify)(void);
+
+// Habilita as interrupcoes RX/RT; o handler da UART do projeto deve chamar UartRxIntHandler
+void UartRxInit(uint32_t base, UartRxNotify notify);
+void UartRxIntHandler(void);
+
+// Consumidor: Peek devolve o trecho contiguo ainda nao lido (sem copia), Consume o libera
+uint32_t UartRxPeek(const char **data);
+void UartRxConsume(uint32_t count);
+uint32_t UartRxRead(char *data, uint32_t max);
+uint32_t UartRxAvailable(void);
+void UartRxGetStats(UartRxStats *stats);
+
+#endif // UART_RX_H
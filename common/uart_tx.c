@@ -0,0 +1,131 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "TM4C129.h"
+#include "inc/hw_uart.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "driverlib/interrupt.h"
+#include "dma.h"
+#include "uart_tx.h"
+
+#define UART_TX_RING_MASK   (UART_TX_RING_SIZE - 1)
+
+// Buffer circular SPSC: so o produtor escreve txHead e so a ISR escreve txTail.
+// Produtores de contextos diferentes precisam ser serializados (mutex nas threads;
+// ISRs de mesma prioridade ja nao se interrompem).
+static char txRing[UART_TX_RING_SIZE];
+static volatile uint32_t txHead;
+static volatile uint32_t txTail;
+static uint32_t txStalls;
+static uint32_t txWritten;
+static uint32_t txBase;
+static uint32_t txInterrupt;
+
+static volatile bool txDmaBusy;
+static uint32_t txDmaChannel;
+static UartTxDone txDmaDone;
+static uint32_t txDmaBlocks;
+static uint32_t txDmaBytes;
+
+void UartTxInit(uint32_t base, uint32_t interrupt) {
+    txBase = base;
+    txInterrupt = interrupt;
+    txHead = txTail = 0;
+
+    // RX em 2 bytes ate UartRxInit (se usada) subir o nivel; o timeout RT pega o resto
+    UARTFIFOLevelSet(base, UART_TX_FIFO_LEVEL, UART_FIFO_RX1_8);
+    UARTTxIntModeSet(base, UART_TXINT_MODE_FIFO);
+    UARTFIFOEnable(base);
+    UARTIntEnable(base, UART_INT_TX);
+}
+
+// Move bytes do buffer para a FIFO; e o unico lugar que avanca txTail
+void UartTxIntHandler(void) {
+    if (txDmaBusy) {
+        // O canal se desliga sozinho ao fim do modo basico
+        if (uDMAChannelIsEnabled(txDmaChannel))
+            return;
+        UARTDMADisable(txBase, UART_DMA_TX);
+        txDmaBusy = false;
+        if (txDmaDone)
+            txDmaDone();
+    }
+
+    uint32_t tail = txTail;
+    uint32_t head = txHead;
+    __DMB();
+    while (tail != head && UARTSpaceAvail(txBase)) {
+        UARTCharPutNonBlocking(txBase, txRing[tail & UART_TX_RING_MASK]);
+        tail++;
+    }
+    txTail = tail;
+}
+
+uint32_t UartTxWrite(const char *data, uint32_t length) {
+    uint32_t head = txHead;
+    uint32_t space = UART_TX_RING_SIZE - (head - txTail);
+    uint32_t count = (length < space) ? length : space;
+    for (uint32_t i = 0; i < count; i++)
+        txRing[(head + i) & UART_TX_RING_MASK] = data[i];
+    __DMB();
+    txHead = head + count;
+    txWritten += count;
+    if (count < length)
+        txStalls++;
+
+    // A interrupcao de nivel so dispara quando a FIFO esvazia; pendurar a ISR da a partida
+    if (count > 0)
+        IntPendSet(txInterrupt);
+    return count;
+}
+
+uint32_t UartTxPutString(const char *str) {
+    uint32_t length = 0;
+    while (str[length] != '\0')
+        length++;
+    return UartTxWrite(str, length);
+}
+
+uint32_t UartTxFree(void) {
+    return UART_TX_RING_SIZE - (txHead - txTail);
+}
+
+void UartTxDmaInit(uint32_t channel, UartTxDone done) {
+    DmaInit();
+    uDMAChannelAssign(channel);
+    txDmaChannel = channel & 0xFF;
+    txDmaDone = done;
+    uDMAChannelAttributeDisable(txDmaChannel, UDMA_ATTR_ALL);
+    uDMAChannelControlSet(txDmaChannel | UDMA_PRI_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_4);
+    UARTIntEnable(txBase, UART_INT_DMATX);
+}
+
+bool UartTxDmaStart(const char *block, uint32_t length) {
+    // Bytes do buffer circular ainda nao entregues a FIFO sairiam depois do bloco
+    if (txDmaBusy || txHead != txTail || length == 0 || length > UART_TX_DMA_MAX)
+        return false;
+    txDmaBusy = true;
+    txDmaBlocks++;
+    txDmaBytes += length;
+    uDMAChannelTransferSet(txDmaChannel | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+                           (void *)block, (void *)(txBase + UART_O_DR), length);
+    uDMAChannelEnable(txDmaChannel);
+    UARTDMAEnable(txBase, UART_DMA_TX);
+    return true;
+}
+
+bool UartTxDmaBusy(void) {
+    return txDmaBusy;
+}
+
+void UartTxFlush(void) {
+    while (txDmaBusy || txHead != txTail || UARTBusy(txBase));
+}
+
+void UartTxGetStats(UartTxStats *stats) {
+    stats->written = txWritten;
+    stats->stalls = txStalls;
+    stats->dmaBlocks = txDmaBlocks;
+    stats->dmaBytes = txDmaBytes;
+}
@@ -0,0 +1,48 @@
+#ifndef UART_TX_H
+#define UART_TX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Transmissao da UART por interrupcao: FIFO de 16 bytes habilitada e um buffer circular
+// que a interrupcao de nivel da FIFO de TX esvazia. Quem escreve nunca espera a UART.
+#ifndef UART_TX_RING_SIZE
+#define UART_TX_RING_SIZE   512     // Potencia de 2
+#endif
+
+#define UART_TX_FIFO_LEVEL  UART_FIFO_TX2_8 // Interrupcao de TX com 4 bytes restantes na FIFO
+#define UART_TX_DMA_MAX     1024    // Maior bloco de uma transferencia basica do uDMA
+
+typedef struct {
+    uint32_t written;       // Bytes aceitos no buffer
+    uint32_t stalls;        // Escritas que nao couberam inteiras (o chamador decide se espera)
+    uint32_t dmaBlocks;     // Blocos enviados por uDMA
+    uint32_t dmaBytes;
+} UartTxStats;
+
+// Chamada pela ISR da UART quando um bloco do uDMA termina
+typedef void (*UartTxDone)(void);
+
+// Habilita as FIFOs e a interrupcao de TX. O handler da UART do projeto (registrado para
+// interrupt) deve chamar UartTxIntHandler a cada entrada, mesmo sem UART_INT_TX no status:
+// a escrita pendura a interrupcao para dar partida na FIFO.
+void UartTxInit(uint32_t base, uint32_t interrupt);
+void UartTxIntHandler(void);
+
+// Copia ate length bytes para o buffer e retorna quantos couberam (pode ser chamada de ISR)
+uint32_t UartTxWrite(const char *data, uint32_t length);
+uint32_t UartTxPutString(const char *str);
+uint32_t UartTxFree(void);
+
+// Envio de blocos inteiros por uDMA (channel e o mapeamento, ex. UDMA_CH9_UART0TX). O bloco
+// nao pode ser alterado ate done; enquanto ele esta em voo a ISR nao mexe na FIFO e o
+// buffer circular so acumula. Start falha se houver bloco em voo ou bytes no buffer.
+void UartTxDmaInit(uint32_t channel, UartTxDone done);
+bool UartTxDmaStart(const char *block, uint32_t length);
+bool UartTxDmaBusy(void);
+
+// Espera o bloco do uDMA, o buffer e o registrador de deslocamento esvaziarem
+void UartTxFlush(void);
+void UartTxGetStats(UartTxStats *stats);
+
+#endif // UART_TX_H
@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "window_stats.h"
+
+bool WindowStatsInit(WindowStats *window, uint32_t length) {
+    if (length == 0 || length > WINDOW_STATS_MAX)
+        return false;
+    window->length = length;
+    window->count = 0;
+    window->head = 0;
+    window->sum = 0;
+    window->total = 0;
+    return true;
+}
+
+void WindowStatsPush(WindowStats *window, uint32_t sample) {
+    if (window->count == window->length)
+        window->sum -= window->samples[window->head];   // A mais antiga esta onde a nova entra
+    else
+        window->count++;
+    window->samples[window->head] = sample;
+    window->sum += sample;
+    window->head = (window->head + 1 == window->length) ? 0 : window->head + 1;
+    window->total++;
+}
+
+bool WindowStatsSetLength(WindowStats *window, uint32_t length) {
+    if (length == 0 || length > WINDOW_STATS_MAX)
+        return false;
+    uint32_t keep = (window->count < length) ? window->count : length;
+
+    // Copia as keep mais recentes, da mais antiga para a mais nova, para o inicio do vetor
+    uint32_t recent[WINDOW_STATS_MAX];
+    uint32_t index = (window->head + window->length - keep) % window->length;
+    for (uint32_t i = 0; i < keep; i++) {
+        recent[i] = window->samples[index];
+        index = (index + 1 == window->length) ? 0 : index + 1;
+    }
+    window->sum = 0;
+    for (uint32_t i = 0; i < keep; i++) {
+        window->samples[i] = recent[i];
+        window->sum += recent[i];
+    }
+    window->length = length;
+    window->count = keep;
+    window->head = (keep == length) ? 0 : keep;
+    return true;
+}
+
+void WindowStatsSnapshot(const WindowStats *window, WindowSnapshot *snapshot) {
+    snapshot->length = window->length;
+    snapshot->count = window->count;
+    snapshot->sum = window->sum;
+    snapshot->last = (window->count == 0) ? 0 : window->samples[(window->head == 0) ? window->length - 1 : window->head - 1];
+    snapshot->total = window->total;
+}
+
+uint32_t WindowSnapshotMean(const WindowSnapshot *snapshot) {
+    return (snapshot->count > 0) ? snapshot->sum / snapshot->count : 0;
+}
@@ -0,0 +1,42 @@
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Media movel das ultimas N amostras com soma corrente: cada amostra nova entra na soma e a
+// que sai da janela e subtraida, O(1) por amostra qualquer que seja N. N pode mudar em tempo
+// de execucao ate WINDOW_STATS_MAX. Nao tem trava propria: quem compartilha a janela entre
+// threads protege WindowStatsPush e WindowStatsSnapshot, que sao curtos de proposito.
+#define WINDOW_STATS_MAX    64
+
+typedef struct {
+    uint32_t samples[WINDOW_STATS_MAX];
+    uint32_t length;        // Tamanho da janela (N)
+    uint32_t count;         // Amostras na janela (ate N)
+    uint32_t head;          // Proxima posicao a escrever
+    uint32_t sum;
+    uint32_t total;         // Amostras recebidas desde o inicio
+} WindowStats;
+
+// Copia consistente para formatar e enviar fora da regiao protegida
+typedef struct {
+    uint32_t length;
+    uint32_t count;
+    uint32_t sum;
+    uint32_t last;
+    uint32_t total;
+} WindowSnapshot;
+
+// Falha com length 0 ou acima de WINDOW_STATS_MAX
+bool WindowStatsInit(WindowStats *window, uint32_t length);
+void WindowStatsPush(WindowStats *window, uint32_t sample);
+
+// Mantem as amostras mais recentes que couberem na nova janela (O(N), so na troca)
+bool WindowStatsSetLength(WindowStats *window, uint32_t length);
+void WindowStatsSnapshot(const WindowStats *window, WindowSnapshot *snapshot);
+
+// Media da janela (0 se vazia)
+uint32_t WindowSnapshotMean(const WindowSnapshot *snapshot);
+
+#endif // WINDOW_STATS_H
@@ -0,0 +1,301 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "fib_bignum.h"
+
+// F(n) has about n * log2(phi) = 0.6942 n bits; 7/320 limbs per n rounds that up
+#define FIB_BIG_MAX_LIMBS         ((FIB_BIG_MAX_N * 7) / 320 + 2)
+#define FIB_BIG_ARENA_WORDS       (18 * FIB_BIG_MAX_LIMBS)
+#define FIB_BIG_KARATSUBA_LIMBS   24      // Below this, schoolbook multiplication is faster
+#define FIB_BIG_EMIT_CHUNK        32      // Digits handed to emit per call
+
+// Fixed limb arena used as a stack: allocations are released back to a saved mark
+static uint32_t bigArena[FIB_BIG_ARENA_WORDS];
+static uint32_t bigArenaTop;
+
+static uint32_t *ArenaAlloc(uint32_t words) {
+    if (words > FIB_BIG_ARENA_WORDS - bigArenaTop)
+        return NULL;
+    uint32_t *p = &bigArena[bigArenaTop];
+    bigArenaTop += words;
+    return p;
+}
+
+static uint32_t Normalize(const uint32_t *a, uint32_t len) {
+    while (len > 0 && a[len - 1] == 0)
+        len--;
+    return len;
+}
+
+static void Copy(uint32_t *r, const uint32_t *a, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++)
+        r[i] = a[i];
+}
+
+// hi:lo = x * y + lo + hi, a single UMAAL on the Cortex-M4
+static inline void MulAddCarry(uint32_t *lo, uint32_t *hi, uint32_t x, uint32_t y) {
+#if defined(__ARM_ARCH_7EM__)
+    __asm("umaal %0, %1, %2, %3" : "+r"(*lo), "+r"(*hi) : "r"(x), "r"(y));
+#else
+    uint64_t t = (uint64_t)x * y + *lo + *hi;
+    *lo = (uint32_t)t;
+    *hi = (uint32_t)(t >> 32);
+#endif
+}
+
+// r[0..an+bn) = a * b
+static void MulSchool(uint32_t *r, const uint32_t *a, uint32_t an, const uint32_t *b, uint32_t bn) {
+    for (uint32_t i = 0; i < an + bn; i++)
+        r[i] = 0;
+    for (uint32_t i = 0; i < an; i++) {
+        uint32_t carry = 0;
+        for (uint32_t j = 0; j < bn; j++)
+            MulAddCarry(&r[i + j], &carry, a[i], b[j]);
+        r[i + bn] = carry;
+    }
+}
+
+// r[0..rn) += a[0..an), an <= rn; returns the carry out of r
+static uint32_t AddInPlace(uint32_t *r, uint32_t rn, const uint32_t *a, uint32_t an) {
+    uint64_t carry = 0;
+    uint32_t i = 0;
+    for (; i < an; i++) {
+        carry += (uint64_t)r[i] + a[i];
+        r[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    for (; carry && i < rn; i++) {
+        carry += r[i];
+        r[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    return (uint32_t)carry;
+}
+
+// r[0..rn) -= a[0..an), an <= rn, r >= a
+static void SubInPlace(uint32_t *r, uint32_t rn, const uint32_t *a, uint32_t an) {
+    uint32_t borrow = 0;
+    uint32_t i = 0;
+    for (; i < an; i++) {
+        uint32_t x = r[i];
+        uint32_t y = a[i] + borrow;
+        borrow = (y < borrow) || (x < y);
+        r[i] = x - y;
+    }
+    for (; borrow && i < rn; i++) {
+        borrow = (r[i] == 0);
+        r[i]--;
+    }
+}
+
+// r[0..2n) = a * b, both n limbs
+static void MulKaratsuba(uint32_t *r, const uint32_t *a, const uint32_t *b, uint32_t n) {
+    if (n < FIB_BIG_KARATSUBA_LIMBS) {
+        MulSchool(r, a, n, b, n);
+        return;
+    }
+
+    uint32_t m = n / 2;
+    uint32_t h = n - m;
+    uint32_t mark = bigArenaTop;
+    uint32_t *sa = ArenaAlloc(h + 1);
+    uint32_t *sb = ArenaAlloc(h + 1);
+    uint32_t *z1 = ArenaAlloc(2 * (h + 1));
+    if (z1 == NULL) {
+        bigArenaTop = mark;
+        MulSchool(r, a, n, b, n);
+        return;
+    }
+
+    // z0 = a0 * b0 in r[0..2m), z2 = a1 * b1 in r[2m..2n)
+    MulKaratsuba(r, a, b, m);
+    MulKaratsuba(r + 2 * m, a + m, b + m, h);
+
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    Copy(sa, a + m, h);
+    sa[h] = AddInPlace(sa, h, a, m);
+    Copy(sb, b + m, h);
+    sb[h] = AddInPlace(sb, h, b, m);
+    MulKaratsuba(z1, sa, sb, h + 1);
+    SubInPlace(z1, 2 * (h + 1), r, 2 * m);
+    SubInPlace(z1, 2 * (h + 1), r + 2 * m, 2 * h);
+
+    // z1 < 2^(32(n+1)), so it fits in the n + h limbs above r[m]
+    AddInPlace(r + m, n + h, z1, Normalize(z1, 2 * (h + 1)));
+    bigArenaTop = mark;
+}
+
+// r = a * b, r has room for an + bn limbs; returns the normalized length
+static uint32_t Mul(uint32_t *r, const uint32_t *a, uint32_t an, const uint32_t *b, uint32_t bn) {
+    if (an == 0 || bn == 0)
+        return 0;
+    if (an < FIB_BIG_KARATSUBA_LIMBS || bn < FIB_BIG_KARATSUBA_LIMBS) {
+        MulSchool(r, a, an, b, bn);
+        return Normalize(r, an + bn);
+    }
+    if (an == bn) {
+        MulKaratsuba(r, a, b, an);
+        return Normalize(r, an + bn);
+    }
+
+    // Pad the shorter operand so Karatsuba sees equal lengths
+    uint32_t n = (an > bn) ? an : bn;
+    uint32_t mark = bigArenaTop;
+    uint32_t *pa = ArenaAlloc(n);
+    uint32_t *pb = ArenaAlloc(n);
+    uint32_t *pr = ArenaAlloc(2 * n);
+    if (pr == NULL) {
+        bigArenaTop = mark;
+        MulSchool(r, a, an, b, bn);
+        return Normalize(r, an + bn);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        pa[i] = (i < an) ? a[i] : 0;
+        pb[i] = (i < bn) ? b[i] : 0;
+    }
+    MulKaratsuba(pr, pa, pb, n);
+    Copy(r, pr, an + bn);
+    bigArenaTop = mark;
+    return Normalize(r, an + bn);
+}
+
+// One fast-doubling step: (a, b) = (F(k), F(k+1)) -> (F(2k), F(2k+1)) or (F(2k+1), F(2k+2))
+static FibBigStatus DoublingStep(uint32_t *a, uint32_t *an, uint32_t *b, uint32_t *bn, int odd) {
+    uint32_t mark = bigArenaTop;
+    uint32_t tn = *bn + 1;
+    uint32_t dn = 2 * *bn + 1;
+    uint32_t *t = ArenaAlloc(tn);
+    uint32_t *c = ArenaAlloc(*an + tn);
+    uint32_t *d = ArenaAlloc(dn);
+    uint32_t *sb = ArenaAlloc(2 * *bn);
+    if (sb == NULL) {
+        bigArenaTop = mark;
+        return FIB_BIG_NO_MEMORY;
+    }
+
+    // t = 2F(k+1) - F(k)
+    Copy(t, b, *bn);
+    t[*bn] = AddInPlace(t, *bn, b, *bn);
+    SubInPlace(t, tn, a, *an);
+    tn = Normalize(t, tn);
+
+    // c = F(k) * t = F(2k),  d = F(k)^2 + F(k+1)^2 = F(2k+1)
+    uint32_t cn = Mul(c, a, *an, t, tn);
+    uint32_t san = Mul(d, a, *an, a, *an);
+    for (uint32_t i = san; i < dn; i++)
+        d[i] = 0;
+    uint32_t sbn = Mul(sb, b, *bn, b, *bn);
+    AddInPlace(d, dn, sb, sbn);
+    dn = Normalize(d, dn);
+
+    if (dn + 1 > FIB_BIG_MAX_LIMBS + 1) {
+        bigArenaTop = mark;
+        return FIB_BIG_NO_MEMORY;
+    }
+    if (odd) {
+        Copy(a, d, dn);
+        *an = dn;
+        Copy(b, d, dn);
+        b[dn] = 0;
+        AddInPlace(b, dn + 1, c, cn);
+        *bn = Normalize(b, dn + 1);
+    } else {
+        Copy(a, c, cn);
+        *an = cn;
+        Copy(b, d, dn);
+        *bn = dn;
+    }
+    bigArenaTop = mark;
+    return FIB_BIG_OK;
+}
+
+// Streams the digits of a[0..an) in base 10, destroying a
+static uint32_t EmitDecimal(uint32_t *a, uint32_t an, FibBigEmit emit, FibCancel *cancel) {
+    // Peel off base-10^4 groups; each 16-bit half of a limb keeps the division in 32 bits
+    uint16_t *groups = (uint16_t *)ArenaAlloc(an * 16 / 13 + 2);
+    uint32_t count = 0;
+    if (groups == NULL)
+        return 0;
+    do {
+        uint32_t rem = 0;
+        for (uint32_t i = an; i-- > 0;) {
+            uint32_t part = (rem << 16) | (a[i] >> 16);
+            uint32_t qh = part / 10000;
+            rem = part - qh * 10000;
+            part = (rem << 16) | (a[i] & 0xFFFF);
+            uint32_t ql = part / 10000;
+            rem = part - ql * 10000;
+            a[i] = (qh << 16) | ql;
+        }
+        groups[count++] = (uint16_t)rem;
+        an = Normalize(a, an);
+        if ((count & 0x3F) == 0 && FibCancelPoll(cancel))
+            return 0;
+    } while (an > 0);
+
+    char chunk[FIB_BIG_EMIT_CHUNK];
+    uint32_t used = 0;
+    uint32_t digits = 0;
+    while (count-- > 0) {
+        char group[4];
+        uint32_t value = groups[count];
+        for (int i = 3; i >= 0; i--) {
+            group[i] = (char)('0' + value % 10);
+            value /= 10;
+        }
+        int start = 0;
+        if (digits == 0) {
+            while (start < 3 && group[start] == '0')
+                start++;   // No leading zeros on the most significant group
+        }
+        for (int i = start; i < 4; i++) {
+            chunk[used++] = group[i];
+            digits++;
+            if (used == FIB_BIG_EMIT_CHUNK) {
+                emit(chunk, used);
+                used = 0;
+            }
+        }
+    }
+    if (used > 0)
+        emit(chunk, used);
+    return digits;
+}
+
+FibBigStatus FibonacciBigStream(uint32_t n, FibBigEmit emit, uint32_t *digits, FibCancel *cancel) {
+    if (n > FIB_BIG_MAX_N)
+        return FIB_BIG_TOO_LARGE;
+
+    bigArenaTop = 0;
+    uint32_t *a = ArenaAlloc(FIB_BIG_MAX_LIMBS + 1);
+    uint32_t *b = ArenaAlloc(FIB_BIG_MAX_LIMBS + 1);
+    uint32_t an, bn;
+    uint64_t small;
+
+    if (FibonacciLookup64(n, &small)) {
+        // Anything that fits in 64 bits comes straight from the flash table
+        a[0] = (uint32_t)small;
+        a[1] = (uint32_t)(small >> 32);
+        an = Normalize(a, 2);
+    } else {
+        a[0] = 0;
+        an = 0;
+        b[0] = 1;
+        bn = 1;
+        for (int bit = 31; bit >= 0; bit--) {
+            if ((n >> bit) == 0)
+                continue;
+            if (FibCancelPoll(cancel))
+                return FIB_BIG_CANCELLED;
+            FibBigStatus status = DoublingStep(a, &an, b, &bn, (n >> bit) & 1);
+            if (status != FIB_BIG_OK)
+                return status;
+        }
+    }
+
+    uint32_t count = EmitDecimal(a, an, emit, cancel);
+    if (count == 0)
+        return FibCancelPoll(cancel) ? FIB_BIG_CANCELLED : FIB_BIG_NO_MEMORY;
+    if (digits)
+        *digits = count;
+    return FIB_BIG_OK;
+}
@@ -0,0 +1,24 @@
+#ifndef FIB_BIGNUM_H
+#define FIB_BIGNUM_H
+
+#include <stdint.h>
+#include "fibonacci.h"
+
+#define FIB_BIG_MAX_N   10000   // Largest n the limb arena is sized for
+
+typedef enum {
+    FIB_BIG_OK = 0,
+    FIB_BIG_TOO_LARGE,      // n > FIB_BIG_MAX_N
+    FIB_BIG_NO_MEMORY,      // Limb arena exhausted
+    FIB_BIG_CANCELLED       // The cancel token fired (see its reason)
+} FibBigStatus;
+
+// Receives the decimal digits of the result, most significant first, a chunk at a time
+typedef void (*FibBigEmit)(const char *digits, uint32_t length);
+
+// Computes F(n) exactly with fast doubling and streams its decimal digits through emit.
+// Uses a single static arena, so only one thread may call it. cancel may be NULL; it is
+// polled between doubling steps and between digit groups.
+FibBigStatus FibonacciBigStream(uint32_t n, FibBigEmit emit, uint32_t *digits, FibCancel *cancel);
+
+#endif // FIB_BIGNUM_H
@@ -0,0 +1,272 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "TM4C129.h"
+#include "cmsis_os2.h"
+#include "fibonacci.h"
+#include "fibonacci_table.h"
+#include "timing.h"
+
+#define FIB_CALIBRATION_RUNS  4     // Runs per calibration point (the fastest one is kept)
+#define FIB_CANCEL_INTERVAL   0xFFF // Iterations/calls between cancellation polls (mask)
+
+static FibEngine fibLogEngine = FIB_ENGINE_FAST_DOUBLING;  // Fastest measured O(log n) engine
+
+static const char *const fibEngineNames[FIB_ENGINE_COUNT] = {
+    "auto", "recursive", "iterative", "fast-doubling", "matrix", "memo", "table"
+};
+
+static const uint32_t fibTable32[FIB_TABLE_MAX_N32 + 1] = FIB_TABLE32_INIT;
+static const uint64_t fibTable64[FIB_TABLE_MAX_N64 + 1] = FIB_TABLE64_INIT;
+
+// Each slot is a small seqlock: odd seq while a writer is inside
+typedef struct {
+    volatile uint32_t seq;
+    volatile uint32_t n;
+    volatile uint32_t value;
+} FibMemoSlot;
+
+static FibMemoSlot fibMemo[FIB_MEMO_SIZE];   // Zeroed slots already hold F(0) = 0
+static volatile uint32_t fibMemoHits;
+static volatile uint32_t fibMemoMisses;
+static volatile uint32_t fibMemoPrecomputed;
+
+static void AtomicIncrement(volatile uint32_t *counter) {
+    uint32_t value;
+    do {
+        value = __LDREXW(counter) + 1;
+    } while (__STREXW(value, counter));
+}
+
+uint32_t FibonacciRecursive(uint32_t n) {
+    if (n <= 1)
+        return n;
+    else
+        return FibonacciRecursive(n - 1) + FibonacciRecursive(n - 2);
+}
+
+bool FibCancelPoll(FibCancel *cancel) {
+    if (cancel == NULL)
+        return false;
+    if (cancel->reason != FIB_CANCEL_NONE)
+        return true;
+    if (cancel->deadline != 0 && (int32_t)(osKernelGetTickCount() - cancel->deadline) >= 0) {
+        cancel->reason = FIB_CANCEL_EXPIRED;
+        return true;
+    }
+    return false;
+}
+
+// Same recursion as the baseline, polling the token every FIB_CANCEL_INTERVAL calls
+static uint32_t RecursiveCancellable(uint32_t n, FibCancel *cancel, uint32_t *calls) {
+    if (((++*calls & FIB_CANCEL_INTERVAL) == 0 && FibCancelPoll(cancel)) || cancel->reason != FIB_CANCEL_NONE)
+        return 0;
+    if (n <= 1)
+        return n;
+    return RecursiveCancellable(n - 1, cancel, calls) + RecursiveCancellable(n - 2, cancel, calls);
+}
+
+static uint32_t IterativeCancellable(uint32_t n, FibCancel *cancel) {
+    uint32_t a = 0, b = 1;
+    while (n--) {
+        uint32_t next = a + b;
+        a = b;
+        b = next;
+        if ((n & FIB_CANCEL_INTERVAL) == 0 && FibCancelPoll(cancel))
+            return 0;
+    }
+    return a;
+}
+
+uint32_t FibonacciIterative(uint32_t n) {
+    return IterativeCancellable(n, NULL);
+}
+
+// F(2k) = F(k) * (2F(k+1) - F(k)),  F(2k+1) = F(k)^2 + F(k+1)^2
+uint32_t FibonacciFastDoubling(uint32_t n) {
+    uint32_t a = 0, b = 1;   // F(k), F(k+1)
+    for (int bit = 31 - __CLZ(n | 1); bit >= 0; bit--) {
+        uint32_t c = a * (2 * b - a);
+        uint32_t d = a * a + b * b;
+        if (n & (1u << bit)) {
+            a = d;
+            b = c + d;
+        } else {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
+
+// [[1,1],[1,0]]^n = [[F(n+1),F(n)],[F(n),F(n-1)]]
+uint32_t FibonacciMatrix(uint32_t n) {
+    uint32_t r00 = 1, r01 = 0, r11 = 1;   // Result (symmetric, r10 == r01)
+    uint32_t m00 = 1, m01 = 1, m11 = 0;   // Base
+    while (n) {
+        if (n & 1) {
+            uint32_t t00 = r00 * m00 + r01 * m01;
+            uint32_t t01 = r00 * m01 + r01 * m11;
+            uint32_t t11 = r01 * m01 + r11 * m11;
+            r00 = t00; r01 = t01; r11 = t11;
+        }
+        uint32_t s00 = m00 * m00 + m01 * m01;
+        uint32_t s01 = m00 * m01 + m01 * m11;
+        uint32_t s11 = m01 * m01 + m11 * m11;
+        m00 = s00; m01 = s01; m11 = s11;
+        n >>= 1;
+    }
+    return r01;
+}
+
+static uint32_t MeasureCycles(uint32_t (*fn)(uint32_t), uint32_t n) {
+    uint32_t best = UINT32_MAX;
+    for (int run = 0; run < FIB_CALIBRATION_RUNS; run++) {
+        uint32_t start = TimingNow();
+        volatile uint32_t result = fn(n);
+        uint32_t cycles = TimingNow() - start;
+        (void)result;
+        if (cycles < best)
+            best = cycles;
+    }
+    return best;
+}
+
+// The table answers every n <= FIB_TABLE_MAX_N32, so the computed path only ever sees larger n,
+// where the O(log n) engines always beat the iterative one: only the two of them are compared
+void FibonacciCalibrate(void) {
+    if (MeasureCycles(FibonacciMatrix, FIB_TABLE_MAX_N32 + 1) < MeasureCycles(FibonacciFastDoubling, FIB_TABLE_MAX_N32 + 1))
+        fibLogEngine = FIB_ENGINE_MATRIX;
+}
+
+FibEngine FibonacciSelectEngine(uint32_t n) {
+    (void)n;
+    return fibLogEngine;
+}
+
+uint32_t FibonacciCompute(uint32_t n, FibEngine engine, FibEngine *used, FibCancel *cancel) {
+    // Only automatic requests use the table and memo; a forced engine always runs (benchmarks)
+    if (engine == FIB_ENGINE_AUTO || engine >= FIB_ENGINE_COUNT) {
+        uint32_t result;
+        if (FibonacciLookup32(n, &result)) {
+            if (used)
+                *used = FIB_ENGINE_TABLE;
+            return result;
+        }
+        if (FibMemoLookup(n, &result)) {
+            AtomicIncrement(&fibMemoHits);
+            if (used)
+                *used = FIB_ENGINE_MEMO;
+            return result;
+        }
+        AtomicIncrement(&fibMemoMisses);
+        engine = FibonacciSelectEngine(n);
+        result = FibonacciCompute(n, engine, used, cancel);
+        if (!FibCancelPoll(cancel))
+            FibMemoStore(n, result);
+        return result;
+    }
+    if (used)
+        *used = engine;
+
+    switch (engine) {
+        case FIB_ENGINE_RECURSIVE:
+            if (cancel != NULL) {
+                uint32_t calls = 0;
+                return RecursiveCancellable(n, cancel, &calls);
+            }
+            return FibonacciRecursive(n);
+        case FIB_ENGINE_ITERATIVE:
+            return IterativeCancellable(n, cancel);
+        case FIB_ENGINE_MATRIX:
+            return FibonacciMatrix(n);
+        case FIB_ENGINE_MEMO:
+        case FIB_ENGINE_TABLE:
+            return FibonacciCompute(n, FIB_ENGINE_AUTO, used, cancel);
+        default:
+            return FibonacciFastDoubling(n);
+    }
+}
+
+const char *FibonacciEngineName(FibEngine engine) {
+    return (engine < FIB_ENGINE_COUNT) ? fibEngineNames[engine] : "?";
+}
+
+bool FibonacciLookup32(uint32_t n, uint32_t *result) {
+    if (n > FIB_TABLE_MAX_N32)
+        return false;
+    *result = fibTable32[n];
+    return true;
+}
+
+bool FibonacciLookup64(uint32_t n, uint64_t *result) {
+    if (n > FIB_TABLE_MAX_N64)
+        return false;
+    *result = fibTable64[n];
+    return true;
+}
+
+// The engines work modulo 2^32, so they must match the low word of every 64-bit entry
+int32_t FibonacciSelfTest(void) {
+    for (uint32_t n = 0; n <= FIB_TABLE_MAX_N64; n++) {
+        uint32_t expected = (uint32_t)fibTable64[n];
+        if ((n <= FIB_TABLE_MAX_N32 && fibTable32[n] != expected) ||
+            FibonacciIterative(n) != expected ||
+            FibonacciFastDoubling(n) != expected ||
+            FibonacciMatrix(n) != expected)
+            return (int32_t)n;
+    }
+    return -1;
+}
+
+bool FibMemoLookup(uint32_t n, uint32_t *result) {
+    FibMemoSlot *slot = &fibMemo[n & (FIB_MEMO_SIZE - 1)];
+    uint32_t seq = slot->seq;
+    if (seq & 1)
+        return false;       // Writer in progress: treat as a miss instead of waiting
+    __DMB();
+    uint32_t key = slot->n;
+    uint32_t value = slot->value;
+    __DMB();
+    if (slot->seq != seq || key != n)
+        return false;
+    *result = value;
+    return true;
+}
+
+void FibMemoStore(uint32_t n, uint32_t result) {
+    FibMemoSlot *slot = &fibMemo[n & (FIB_MEMO_SIZE - 1)];
+    uint32_t seq;
+    do {
+        seq = __LDREXW(&slot->seq);
+        if (seq & 1) {
+            __CLREX();
+            return;         // Another thread is filling this slot; the cache can skip it
+        }
+    } while (__STREXW(seq + 1, &slot->seq));
+    __DMB();
+    slot->n = n;
+    slot->value = result;
+    __DMB();
+    slot->seq = seq + 2;
+}
+
+// Fills the neighbours of n that are not cached yet; returns how many were computed
+uint32_t FibMemoPrecompute(uint32_t n) {
+    uint32_t computed = 0;
+    for (int32_t offset = -FIB_MEMO_RADIUS; offset <= FIB_MEMO_RADIUS; offset++) {
+        uint32_t m = n + (uint32_t)offset;
+        uint32_t result;
+        if (offset == 0 || (offset < 0 && n < (uint32_t)-offset) || FibMemoLookup(m, &result))
+            continue;
+        FibMemoStore(m, FibonacciCompute(m, FibonacciSelectEngine(m), NULL, NULL));
+        AtomicIncrement(&fibMemoPrecomputed);
+        computed++;
+    }
+    return computed;
+}
+
+void FibMemoGetStats(FibMemoStats *stats) {
+    stats->hits = fibMemoHits;
+    stats->misses = fibMemoMisses;
+    stats->precomputed = fibMemoPrecomputed;
+}
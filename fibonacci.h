@@ -0,0 +1,69 @@
+#ifndef FIBONACCI_H
+#define FIBONACCI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Available Fibonacci algorithms
+typedef enum {
+    FIB_ENGINE_AUTO = 0,        // Table for n <= 47, else the O(log n) engine measured fastest at boot
+    FIB_ENGINE_RECURSIVE,       // O(phi^n) - benchmark mode only
+    FIB_ENGINE_ITERATIVE,       // O(n)
+    FIB_ENGINE_FAST_DOUBLING,   // O(log n)
+    FIB_ENGINE_MATRIX,          // O(log n) - 2x2 matrix power
+    FIB_ENGINE_MEMO,            // Served from the shared memo table
+    FIB_ENGINE_TABLE,           // O(1) lookup in the flash table
+    FIB_ENGINE_COUNT
+} FibEngine;
+
+uint32_t FibonacciRecursive(uint32_t n);
+uint32_t FibonacciIterative(uint32_t n);
+uint32_t FibonacciFastDoubling(uint32_t n);
+uint32_t FibonacciMatrix(uint32_t n);
+
+// Times matrix against fast doubling at boot (call after TimingInit, before the kernel starts)
+void FibonacciCalibrate(void);
+
+// Cooperative cancellation: long-running engines poll the token at safe points
+typedef enum {
+    FIB_CANCEL_NONE = 0,
+    FIB_CANCEL_REQUESTED,   // 'cancel <id>' from the UART
+    FIB_CANCEL_EXPIRED      // The request deadline passed
+} FibCancelReason;
+
+typedef struct {
+    volatile FibCancelReason reason;
+    uint32_t deadline;      // Kernel tick, 0 = no deadline
+} FibCancel;
+
+// Returns true (and latches the reason) once the request was cancelled or its deadline passed
+bool FibCancelPoll(FibCancel *cancel);
+
+FibEngine FibonacciSelectEngine(uint32_t n);
+// cancel may be NULL; if the token fires the result is meaningless and is not memoized
+uint32_t FibonacciCompute(uint32_t n, FibEngine engine, FibEngine *used, FibCancel *cancel);
+const char *FibonacciEngineName(FibEngine engine);
+
+// Flash table covering every n whose F(n) fits in 32/64 bits
+bool FibonacciLookup32(uint32_t n, uint32_t *result);
+bool FibonacciLookup64(uint32_t n, uint64_t *result);
+
+// Checks the flash table against the runtime engines; returns the first bad n or -1
+int32_t FibonacciSelfTest(void);
+
+// Shared memo table: lock-free for readers, any thread may fill it
+#define FIB_MEMO_SIZE     64    // Slots (power of two, direct mapped by n)
+#define FIB_MEMO_RADIUS   2     // Neighbours of each request precomputed while idle
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t precomputed;
+} FibMemoStats;
+
+bool FibMemoLookup(uint32_t n, uint32_t *result);
+void FibMemoStore(uint32_t n, uint32_t result);
+uint32_t FibMemoPrecompute(uint32_t n);
+void FibMemoGetStats(FibMemoStats *stats);
+
+#endif // FIBONACCI_H
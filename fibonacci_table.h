@@ -0,0 +1,224 @@
+#ifndef FIBONACCI_TABLE_H
+#define FIBONACCI_TABLE_H
+
+// F(0)..F(93), every Fibonacci number that fits in uint64_t. The values are plain
+// integer constants, so the tables built from them live in flash and the recurrence
+// below is checked by the compiler.
+
+#define FIB_TABLE_MAX_N32  47    // F(47) is the last value that fits in uint32_t
+#define FIB_TABLE_MAX_N64  93    // F(93) is the last value that fits in uint64_t
+
+#define FIB_0   0ULL
+#define FIB_1   1ULL
+#define FIB_2   1ULL
+#define FIB_3   2ULL
+#define FIB_4   3ULL
+#define FIB_5   5ULL
+#define FIB_6   8ULL
+#define FIB_7   13ULL
+#define FIB_8   21ULL
+#define FIB_9   34ULL
+#define FIB_10  55ULL
+#define FIB_11  89ULL
+#define FIB_12  144ULL
+#define FIB_13  233ULL
+#define FIB_14  377ULL
+#define FIB_15  610ULL
+#define FIB_16  987ULL
+#define FIB_17  1597ULL
+#define FIB_18  2584ULL
+#define FIB_19  4181ULL
+#define FIB_20  6765ULL
+#define FIB_21  10946ULL
+#define FIB_22  17711ULL
+#define FIB_23  28657ULL
+#define FIB_24  46368ULL
+#define FIB_25  75025ULL
+#define FIB_26  121393ULL
+#define FIB_27  196418ULL
+#define FIB_28  317811ULL
+#define FIB_29  514229ULL
+#define FIB_30  832040ULL
+#define FIB_31  1346269ULL
+#define FIB_32  2178309ULL
+#define FIB_33  3524578ULL
+#define FIB_34  5702887ULL
+#define FIB_35  9227465ULL
+#define FIB_36  14930352ULL
+#define FIB_37  24157817ULL
+#define FIB_38  39088169ULL
+#define FIB_39  63245986ULL
+#define FIB_40  102334155ULL
+#define FIB_41  165580141ULL
+#define FIB_42  267914296ULL
+#define FIB_43  433494437ULL
+#define FIB_44  701408733ULL
+#define FIB_45  1134903170ULL
+#define FIB_46  1836311903ULL
+#define FIB_47  2971215073ULL
+#define FIB_48  4807526976ULL
+#define FIB_49  7778742049ULL
+#define FIB_50  12586269025ULL
+#define FIB_51  20365011074ULL
+#define FIB_52  32951280099ULL
+#define FIB_53  53316291173ULL
+#define FIB_54  86267571272ULL
+#define FIB_55  139583862445ULL
+#define FIB_56  225851433717ULL
+#define FIB_57  365435296162ULL
+#define FIB_58  591286729879ULL
+#define FIB_59  956722026041ULL
+#define FIB_60  1548008755920ULL
+#define FIB_61  2504730781961ULL
+#define FIB_62  4052739537881ULL
+#define FIB_63  6557470319842ULL
+#define FIB_64  10610209857723ULL
+#define FIB_65  17167680177565ULL
+#define FIB_66  27777890035288ULL
+#define FIB_67  44945570212853ULL
+#define FIB_68  72723460248141ULL
+#define FIB_69  117669030460994ULL
+#define FIB_70  190392490709135ULL
+#define FIB_71  308061521170129ULL
+#define FIB_72  498454011879264ULL
+#define FIB_73  806515533049393ULL
+#define FIB_74  1304969544928657ULL
+#define FIB_75  2111485077978050ULL
+#define FIB_76  3416454622906707ULL
+#define FIB_77  5527939700884757ULL
+#define FIB_78  8944394323791464ULL
+#define FIB_79  14472334024676221ULL
+#define FIB_80  23416728348467685ULL
+#define FIB_81  37889062373143906ULL
+#define FIB_82  61305790721611591ULL
+#define FIB_83  99194853094755497ULL
+#define FIB_84  160500643816367088ULL
+#define FIB_85  259695496911122585ULL
+#define FIB_86  420196140727489673ULL
+#define FIB_87  679891637638612258ULL
+#define FIB_88  1100087778366101931ULL
+#define FIB_89  1779979416004714189ULL
+#define FIB_90  2880067194370816120ULL
+#define FIB_91  4660046610375530309ULL
+#define FIB_92  7540113804746346429ULL
+#define FIB_93  12200160415121876738ULL
+
+#define FIB_TABLE32_INIT { \
+    FIB_0, FIB_1, FIB_2, FIB_3, FIB_4, FIB_5, FIB_6, FIB_7, \
+    FIB_8, FIB_9, FIB_10, FIB_11, FIB_12, FIB_13, FIB_14, FIB_15, \
+    FIB_16, FIB_17, FIB_18, FIB_19, FIB_20, FIB_21, FIB_22, FIB_23, \
+    FIB_24, FIB_25, FIB_26, FIB_27, FIB_28, FIB_29, FIB_30, FIB_31, \
+    FIB_32, FIB_33, FIB_34, FIB_35, FIB_36, FIB_37, FIB_38, FIB_39, \
+    FIB_40, FIB_41, FIB_42, FIB_43, FIB_44, FIB_45, FIB_46, FIB_47 \
+}
+
+#define FIB_TABLE64_INIT { \
+    FIB_0, FIB_1, FIB_2, FIB_3, FIB_4, FIB_5, FIB_6, FIB_7, \
+    FIB_8, FIB_9, FIB_10, FIB_11, FIB_12, FIB_13, FIB_14, FIB_15, \
+    FIB_16, FIB_17, FIB_18, FIB_19, FIB_20, FIB_21, FIB_22, FIB_23, \
+    FIB_24, FIB_25, FIB_26, FIB_27, FIB_28, FIB_29, FIB_30, FIB_31, \
+    FIB_32, FIB_33, FIB_34, FIB_35, FIB_36, FIB_37, FIB_38, FIB_39, \
+    FIB_40, FIB_41, FIB_42, FIB_43, FIB_44, FIB_45, FIB_46, FIB_47, \
+    FIB_48, FIB_49, FIB_50, FIB_51, FIB_52, FIB_53, FIB_54, FIB_55, \
+    FIB_56, FIB_57, FIB_58, FIB_59, FIB_60, FIB_61, FIB_62, FIB_63, \
+    FIB_64, FIB_65, FIB_66, FIB_67, FIB_68, FIB_69, FIB_70, FIB_71, \
+    FIB_72, FIB_73, FIB_74, FIB_75, FIB_76, FIB_77, FIB_78, FIB_79, \
+    FIB_80, FIB_81, FIB_82, FIB_83, FIB_84, FIB_85, FIB_86, FIB_87, \
+    FIB_88, FIB_89, FIB_90, FIB_91, FIB_92, FIB_93 \
+}
+
+_Static_assert(FIB_47 <= 0xFFFFFFFFULL && FIB_48 > 0xFFFFFFFFULL, "FIB_TABLE_MAX_N32 is wrong");
+_Static_assert(FIB_2 == FIB_1 + FIB_0, "F(2) != F(1) + F(0)");
+_Static_assert(FIB_3 == FIB_2 + FIB_1, "F(3) != F(2) + F(1)");
+_Static_assert(FIB_4 == FIB_3 + FIB_2, "F(4) != F(3) + F(2)");
+_Static_assert(FIB_5 == FIB_4 + FIB_3, "F(5) != F(4) + F(3)");
+_Static_assert(FIB_6 == FIB_5 + FIB_4, "F(6) != F(5) + F(4)");
+_Static_assert(FIB_7 == FIB_6 + FIB_5, "F(7) != F(6) + F(5)");
+_Static_assert(FIB_8 == FIB_7 + FIB_6, "F(8) != F(7) + F(6)");
+_Static_assert(FIB_9 == FIB_8 + FIB_7, "F(9) != F(8) + F(7)");
+_Static_assert(FIB_10 == FIB_9 + FIB_8, "F(10) != F(9) + F(8)");
+_Static_assert(FIB_11 == FIB_10 + FIB_9, "F(11) != F(10) + F(9)");
+_Static_assert(FIB_12 == FIB_11 + FIB_10, "F(12) != F(11) + F(10)");
+_Static_assert(FIB_13 == FIB_12 + FIB_11, "F(13) != F(12) + F(11)");
+_Static_assert(FIB_14 == FIB_13 + FIB_12, "F(14) != F(13) + F(12)");
+_Static_assert(FIB_15 == FIB_14 + FIB_13, "F(15) != F(14) + F(13)");
+_Static_assert(FIB_16 == FIB_15 + FIB_14, "F(16) != F(15) + F(14)");
+_Static_assert(FIB_17 == FIB_16 + FIB_15, "F(17) != F(16) + F(15)");
+_Static_assert(FIB_18 == FIB_17 + FIB_16, "F(18) != F(17) + F(16)");
+_Static_assert(FIB_19 == FIB_18 + FIB_17, "F(19) != F(18) + F(17)");
+_Static_assert(FIB_20 == FIB_19 + FIB_18, "F(20) != F(19) + F(18)");
+_Static_assert(FIB_21 == FIB_20 + FIB_19, "F(21) != F(20) + F(19)");
+_Static_assert(FIB_22 == FIB_21 + FIB_20, "F(22) != F(21) + F(20)");
+_Static_assert(FIB_23 == FIB_22 + FIB_21, "F(23) != F(22) + F(21)");
+_Static_assert(FIB_24 == FIB_23 + FIB_22, "F(24) != F(23) + F(22)");
+_Static_assert(FIB_25 == FIB_24 + FIB_23, "F(25) != F(24) + F(23)");
+_Static_assert(FIB_26 == FIB_25 + FIB_24, "F(26) != F(25) + F(24)");
+_Static_assert(FIB_27 == FIB_26 + FIB_25, "F(27) != F(26) + F(25)");
+_Static_assert(FIB_28 == FIB_27 + FIB_26, "F(28) != F(27) + F(26)");
+_Static_assert(FIB_29 == FIB_28 + FIB_27, "F(29) != F(28) + F(27)");
+_Static_assert(FIB_30 == FIB_29 + FIB_28, "F(30) != F(29) + F(28)");
+_Static_assert(FIB_31 == FIB_30 + FIB_29, "F(31) != F(30) + F(29)");
+_Static_assert(FIB_32 == FIB_31 + FIB_30, "F(32) != F(31) + F(30)");
+_Static_assert(FIB_33 == FIB_32 + FIB_31, "F(33) != F(32) + F(31)");
+_Static_assert(FIB_34 == FIB_33 + FIB_32, "F(34) != F(33) + F(32)");
+_Static_assert(FIB_35 == FIB_34 + FIB_33, "F(35) != F(34) + F(33)");
+_Static_assert(FIB_36 == FIB_35 + FIB_34, "F(36) != F(35) + F(34)");
+_Static_assert(FIB_37 == FIB_36 + FIB_35, "F(37) != F(36) + F(35)");
+_Static_assert(FIB_38 == FIB_37 + FIB_36, "F(38) != F(37) + F(36)");
+_Static_assert(FIB_39 == FIB_38 + FIB_37, "F(39) != F(38) + F(37)");
+_Static_assert(FIB_40 == FIB_39 + FIB_38, "F(40) != F(39) + F(38)");
+_Static_assert(FIB_41 == FIB_40 + FIB_39, "F(41) != F(40) + F(39)");
+_Static_assert(FIB_42 == FIB_41 + FIB_40, "F(42) != F(41) + F(40)");
+_Static_assert(FIB_43 == FIB_42 + FIB_41, "F(43) != F(42) + F(41)");
+_Static_assert(FIB_44 == FIB_43 + FIB_42, "F(44) != F(43) + F(42)");
+_Static_assert(FIB_45 == FIB_44 + FIB_43, "F(45) != F(44) + F(43)");
+_Static_assert(FIB_46 == FIB_45 + FIB_44, "F(46) != F(45) + F(44)");
+_Static_assert(FIB_47 == FIB_46 + FIB_45, "F(47) != F(46) + F(45)");
+_Static_assert(FIB_48 == FIB_47 + FIB_46, "F(48) != F(47) + F(46)");
+_Static_assert(FIB_49 == FIB_48 + FIB_47, "F(49) != F(48) + F(47)");
+_Static_assert(FIB_50 == FIB_49 + FIB_48, "F(50) != F(49) + F(48)");
+_Static_assert(FIB_51 == FIB_50 + FIB_49, "F(51) != F(50) + F(49)");
+_Static_assert(FIB_52 == FIB_51 + FIB_50, "F(52) != F(51) + F(50)");
+_Static_assert(FIB_53 == FIB_52 + FIB_51, "F(53) != F(52) + F(51)");
+_Static_assert(FIB_54 == FIB_53 + FIB_52, "F(54) != F(53) + F(52)");
+_Static_assert(FIB_55 == FIB_54 + FIB_53, "F(55) != F(54) + F(53)");
+_Static_assert(FIB_56 == FIB_55 + FIB_54, "F(56) != F(55) + F(54)");
+_Static_assert(FIB_57 == FIB_56 + FIB_55, "F(57) != F(56) + F(55)");
+_Static_assert(FIB_58 == FIB_57 + FIB_56, "F(58) != F(57) + F(56)");
+_Static_assert(FIB_59 == FIB_58 + FIB_57, "F(59) != F(58) + F(57)");
+_Static_assert(FIB_60 == FIB_59 + FIB_58, "F(60) != F(59) + F(58)");
+_Static_assert(FIB_61 == FIB_60 + FIB_59, "F(61) != F(60) + F(59)");
+_Static_assert(FIB_62 == FIB_61 + FIB_60, "F(62) != F(61) + F(60)");
+_Static_assert(FIB_63 == FIB_62 + FIB_61, "F(63) != F(62) + F(61)");
+_Static_assert(FIB_64 == FIB_63 + FIB_62, "F(64) != F(63) + F(62)");
+_Static_assert(FIB_65 == FIB_64 + FIB_63, "F(65) != F(64) + F(63)");
+_Static_assert(FIB_66 == FIB_65 + FIB_64, "F(66) != F(65) + F(64)");
+_Static_assert(FIB_67 == FIB_66 + FIB_65, "F(67) != F(66) + F(65)");
+_Static_assert(FIB_68 == FIB_67 + FIB_66, "F(68) != F(67) + F(66)");
+_Static_assert(FIB_69 == FIB_68 + FIB_67, "F(69) != F(68) + F(67)");
+_Static_assert(FIB_70 == FIB_69 + FIB_68, "F(70) != F(69) + F(68)");
+_Static_assert(FIB_71 == FIB_70 + FIB_69, "F(71) != F(70) + F(69)");
+_Static_assert(FIB_72 == FIB_71 + FIB_70, "F(72) != F(71) + F(70)");
+_Static_assert(FIB_73 == FIB_72 + FIB_71, "F(73) != F(72) + F(71)");
+_Static_assert(FIB_74 == FIB_73 + FIB_72, "F(74) != F(73) + F(72)");
+_Static_assert(FIB_75 == FIB_74 + FIB_73, "F(75) != F(74) + F(73)");
+_Static_assert(FIB_76 == FIB_75 + FIB_74, "F(76) != F(75) + F(74)");
+_Static_assert(FIB_77 == FIB_76 + FIB_75, "F(77) != F(76) + F(75)");
+_Static_assert(FIB_78 == FIB_77 + FIB_76, "F(78) != F(77) + F(76)");
+_Static_assert(FIB_79 == FIB_78 + FIB_77, "F(79) != F(78) + F(77)");
+_Static_assert(FIB_80 == FIB_79 + FIB_78, "F(80) != F(79) + F(78)");
+_Static_assert(FIB_81 == FIB_80 + FIB_79, "F(81) != F(80) + F(79)");
+_Static_assert(FIB_82 == FIB_81 + FIB_80, "F(82) != F(81) + F(80)");
+_Static_assert(FIB_83 == FIB_82 + FIB_81, "F(83) != F(82) + F(81)");
+_Static_assert(FIB_84 == FIB_83 + FIB_82, "F(84) != F(83) + F(82)");
+_Static_assert(FIB_85 == FIB_84 + FIB_83, "F(85) != F(84) + F(83)");
+_Static_assert(FIB_86 == FIB_85 + FIB_84, "F(86) != F(85) + F(84)");
+_Static_assert(FIB_87 == FIB_86 + FIB_85, "F(87) != F(86) + F(85)");
+_Static_assert(FIB_88 == FIB_87 + FIB_86, "F(88) != F(87) + F(86)");
+_Static_assert(FIB_89 == FIB_88 + FIB_87, "F(89) != F(88) + F(87)");
+_Static_assert(FIB_90 == FIB_89 + FIB_88, "F(90) != F(89) + F(88)");
+_Static_assert(FIB_91 == FIB_90 + FIB_89, "F(91) != F(90) + F(89)");
+_Static_assert(FIB_92 == FIB_91 + FIB_90, "F(92) != F(91) + F(90)");
+_Static_assert(FIB_93 == FIB_92 + FIB_91, "F(93) != F(92) + F(91)");
+
+#endif // FIBONACCI_TABLE_H
@@ -0,0 +1,156 @@
+// Confere common/filter.c contra a referencia de host/filter_ref.cpp, bit a bit, em varios
+// sinais e tamanhos de bloco, e mede o custo de cada estagio:
+//   cc -std=c11 -O2 -I common -c common/filter.c common/timing.c
+//   c++ -std=c++17 -O2 -I common -o filter_check host/filter_ref.cpp host/filter_check.cpp filter.o timing.o
+//   ./filter_check
+// No host a unidade de tempo de common/timing.h e o nanossegundo; no alvo o firmware mostra
+// os ciclos por amostra de cada estagio pelo mesmo FilterStageCyclesPer100.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+#include "filter_ref.hpp"
+
+extern "C" {
+#include "filter.h"
+}
+
+namespace {
+
+// Os mesmos estagios que os firmwares montam, e alguns nos limites das faixas
+const std::vector<int16_t> BOXCAR8(8, 4096);
+const std::vector<int16_t> LOWPASS7 = {-512, 1536, 8192, 12288, 8192, 1536, -512};    // sum |c| = 1
+const std::array<int16_t, 5> BUTTER500 = {91, 181, 91, -29141, 13120};     // 500 Hz a 20 kHz
+const std::array<int16_t, 5> RESONANT = {4096, 0, -4096, -31000, 15500};
+
+struct Config {
+    const char *name;
+    std::function<void(FilterChain &, filterref::Chain &)> build;
+};
+
+void Require(bool added) {
+    if (!added) {
+        std::fprintf(stderr, "estagio recusado pela cadeia\n");
+        std::exit(2);
+    }
+}
+
+void AddFir(FilterChain &chain, filterref::Chain &ref, const std::vector<int16_t> &c) {
+    Require(FilterChainAddFir(&chain, c.data(), uint32_t(c.size())));
+    ref.Add(std::make_unique<filterref::Fir>(c));
+}
+
+void AddBiquad(FilterChain &chain, filterref::Chain &ref, const std::array<int16_t, 5> &c) {
+    Require(FilterChainAddBiquad(&chain, c.data()));
+    ref.Add(std::make_unique<filterref::Biquad>(c));
+}
+
+void AddMedian(FilterChain &chain, filterref::Chain &ref, uint32_t window) {
+    Require(FilterChainAddMedian(&chain, window));
+    ref.Add(std::make_unique<filterref::Median>(window));
+}
+
+void AddEma(FilterChain &chain, filterref::Chain &ref, int16_t alpha) {
+    Require(FilterChainAddEma(&chain, alpha));
+    ref.Add(std::make_unique<filterref::Ema>(alpha));
+}
+
+const Config CONFIGS[] = {
+    {"fir boxcar 8", [](FilterChain &c, filterref::Chain &r) { AddFir(c, r, BOXCAR8); }},
+    {"fir 7 taps", [](FilterChain &c, filterref::Chain &r) { AddFir(c, r, LOWPASS7); }},
+    {"biquad 500 Hz", [](FilterChain &c, filterref::Chain &r) { AddBiquad(c, r, BUTTER500); }},
+    {"biquad ressonante", [](FilterChain &c, filterref::Chain &r) { AddBiquad(c, r, RESONANT); }},
+    {"mediana 1", [](FilterChain &c, filterref::Chain &r) { AddMedian(c, r, 1); }},
+    {"mediana 5", [](FilterChain &c, filterref::Chain &r) { AddMedian(c, r, 5); }},
+    {"mediana 15", [](FilterChain &c, filterref::Chain &r) { AddMedian(c, r, FILTER_MEDIAN_MAX); }},
+    {"ema 0,05", [](FilterChain &c, filterref::Chain &r) { AddEma(c, r, 1638); }},
+    {"ema 0,99", [](FilterChain &c, filterref::Chain &r) { AddEma(c, r, 32767); }},
+    {"lab4: mediana 5, fir 8, biquad", [](FilterChain &c, filterref::Chain &r) {
+        AddMedian(c, r, 5);
+        AddFir(c, r, BOXCAR8);
+        AddBiquad(c, r, BUTTER500);
+    }},
+    {"lab2: mediana 3, ema", [](FilterChain &c, filterref::Chain &r) {
+        AddMedian(c, r, 3);
+        AddEma(c, r, 3277);
+    }},
+};
+
+// Gerador congruente: o mesmo sinal em toda execucao
+uint32_t rng = 12345;
+int16_t Noise() {
+    rng = rng * 1664525u + 1013904223u;
+    return int16_t(rng >> 16);
+}
+
+std::vector<int16_t> MakeSignal(int kind, size_t length) {
+    std::vector<int16_t> s(length);
+    for (size_t i = 0; i < length; i++) {
+        switch (kind) {
+            case 0: s[i] = Noise(); break;                                  // Escala cheia
+            case 1: s[i] = int16_t(16000 * std::sin(i * 0.01) + Noise() / 16); break;
+            case 2: s[i] = int16_t(((i / 500) % 2 ? 30000 : -30000) + (i % 97 == 0 ? Noise() : 0)); break;
+            default: s[i] = int16_t((i % 4095) << 3); break;                // Rampa do ADC em Q15
+        }
+    }
+    return s;
+}
+
+} // namespace
+
+int main() {
+    const size_t LENGTH = 20000;
+    int failures = 0;
+
+    for (const Config &config : CONFIGS) {
+        for (int kind = 0; kind < 4; kind++) {
+            FilterChain chain;
+            filterref::Chain ref;
+            FilterChainInit(&chain);
+            config.build(chain, ref);
+
+            std::vector<int16_t> input = MakeSignal(kind, LENGTH);
+            std::vector<int16_t> expected = input;
+            std::vector<int16_t> output = input;
+            ref.Process(expected.data(), expected.size());
+
+            // Blocos de tamanhos variados para exercitar o estado entre chamadas
+            for (size_t done = 0; done < LENGTH;) {
+                size_t block = std::min<size_t>(1 + Noise() % 97u, LENGTH - done);
+                FilterChainProcess(&chain, output.data() + done, uint32_t(block));
+                done += block;
+            }
+            for (size_t i = 0; i < LENGTH; i++) {
+                if (output[i] != expected[i]) {
+                    std::printf("FALHA %s, sinal %d, amostra %zu: %d em vez de %d\n",
+                                config.name, kind, i, output[i], expected[i]);
+                    failures++;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Custo por estagio com blocos de 500, como no Lab4
+    std::printf("%-32s %s\n", "cadeia", "ns por 100 amostras, por estagio");
+    for (const Config &config : CONFIGS) {
+        FilterChain chain;
+        filterref::Chain ref;
+        FilterChainInit(&chain);
+        config.build(chain, ref);
+        std::vector<int16_t> signal = MakeSignal(1, 500);
+        for (int round = 0; round < 400; round++) {
+            std::vector<int16_t> block = signal;
+            FilterChainProcess(&chain, block.data(), uint32_t(block.size()));
+        }
+        std::printf("%-32s", config.name);
+        for (uint32_t i = 0; i < chain.count; i++)
+            std::printf(" %s %u", FilterTypeName(FilterType(chain.stages[i].type)), FilterStageCyclesPer100(&chain, i));
+        std::printf("\n");
+    }
+
+    std::printf(failures ? "%d configuracoes divergem da referencia\n" : "saida identica a referencia\n", failures);
+    return failures ? 1 : 0;
+}
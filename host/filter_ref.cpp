@@ -0,0 +1,68 @@
+#include <algorithm>
+#include "filter_ref.hpp"
+
+namespace filterref {
+
+namespace {
+
+int16_t Sat16(int64_t value) {
+    return int16_t(std::clamp<int64_t>(value, INT16_MIN, INT16_MAX));
+}
+
+} // namespace
+
+Fir::Fir(std::vector<int16_t> coeffs) : coeffs_(std::move(coeffs)), history_(coeffs_.size(), 0) {}
+
+int16_t Fir::Step(int16_t x) {
+    history_.pop_back();
+    history_.push_front(x);
+    int64_t acc = 0;
+    for (size_t k = 0; k < coeffs_.size(); k++)
+        acc += int32_t(coeffs_[k]) * history_[k];
+    return Sat16((acc + (1 << 14)) >> 15);
+}
+
+Biquad::Biquad(const std::array<int16_t, 5> &coeffs) : c_(coeffs) {}
+
+int16_t Biquad::Step(int16_t x) {
+    int64_t acc = int64_t(c_[0]) * x + int64_t(c_[1]) * x1_ + int64_t(c_[2]) * x2_
+                - int64_t(c_[3]) * y1_ - int64_t(c_[4]) * y2_;
+    int16_t y = Sat16((acc + (1 << 13)) >> 14);
+    x2_ = x1_;
+    x1_ = x;
+    y2_ = y1_;
+    y1_ = y;
+    return y;
+}
+
+Median::Median(size_t window) : window_(window) {}
+
+int16_t Median::Step(int16_t x) {
+    recent_.push_back(x);
+    if (recent_.size() > window_)
+        recent_.pop_front();
+    std::vector<int16_t> sorted(recent_.begin(), recent_.end());
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[(sorted.size() - 1) / 2];
+}
+
+Ema::Ema(int16_t alpha) : alpha_(alpha) {}
+
+int16_t Ema::Step(int16_t x) {
+    if (!primed_) {
+        primed_ = true;
+        state_ = int32_t(x) * 65536;
+        return x;
+    }
+    int64_t diff = int64_t(x) * 65536 - state_;
+    state_ += int32_t((diff * alpha_) >> 15);
+    return Sat16((int64_t(state_) + (1 << 15)) >> 16);
+}
+
+void Chain::Process(int16_t *samples, size_t count) {
+    for (size_t i = 0; i < count; i++)
+        for (auto &stage : stages_)
+            samples[i] = stage->Step(samples[i]);
+}
+
+} // namespace filterref
@@ -0,0 +1,74 @@
+// Implementacao de referencia dos estagios de common/filter.h, escrita direto das formulas
+// (sem SIMD, sem linha de atraso duplicada, mediana por ordenacao) para conferir a versao do
+// firmware bit a bit no host.
+#ifndef HOST_FILTER_REF_HPP
+#define HOST_FILTER_REF_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace filterref {
+
+class Stage {
+public:
+    virtual ~Stage() = default;
+    virtual int16_t Step(int16_t x) = 0;
+};
+
+class Fir : public Stage {
+public:
+    explicit Fir(std::vector<int16_t> coeffs);
+    int16_t Step(int16_t x) override;
+
+private:
+    std::vector<int16_t> coeffs_;
+    std::deque<int16_t> history_;       // history_[k] = x[n-k]
+};
+
+class Biquad : public Stage {
+public:
+    explicit Biquad(const std::array<int16_t, 5> &coeffs);     // b0 b1 b2 a1 a2, Q14
+    int16_t Step(int16_t x) override;
+
+private:
+    std::array<int16_t, 5> c_;
+    int16_t x1_ = 0, x2_ = 0, y1_ = 0, y2_ = 0;
+};
+
+class Median : public Stage {
+public:
+    explicit Median(size_t window);
+    int16_t Step(int16_t x) override;
+
+private:
+    size_t window_;
+    std::deque<int16_t> recent_;
+};
+
+class Ema : public Stage {
+public:
+    explicit Ema(int16_t alpha);
+    int16_t Step(int16_t x) override;
+
+private:
+    int16_t alpha_;
+    bool primed_ = false;
+    int32_t state_ = 0;
+};
+
+class Chain {
+public:
+    void Add(std::unique_ptr<Stage> stage) { stages_.push_back(std::move(stage)); }
+    void Process(int16_t *samples, size_t count);
+
+private:
+    std::vector<std::unique_ptr<Stage>> stages_;
+};
+
+} // namespace filterref
+
+#endif // HOST_FILTER_REF_HPP
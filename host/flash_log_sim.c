@@ -0,0 +1,70 @@
+// Roda o common/flash_log sobre um arquivo no lugar da flash, sem placa:
+//   cc -std=c11 -I common -o flash_log_sim common/flash_log.c host/flash_log_sim.c
+//   ./flash_log_sim log.bin capture amostras.txt [tag]    acrescenta as amostras em blocos
+//   ./flash_log_sim log.bin dump                          lista os registros, do mais antigo
+//   ./flash_log_sim log.bin erase
+// O arquivo guarda a imagem da regiao (64 KB) entre execucoes, como a flash entre resets;
+// amostras.txt tem um valor de 0 a 4095 por linha (ou separados por espaco).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "flash_log.h"
+
+static int Capture(const char *path, uint8_t tag) {
+    FILE *input = fopen(path, "r");
+    if (input == NULL) {
+        perror(path);
+        return 1;
+    }
+    FlashLogBlock block = {0};
+    unsigned sample;
+    uint32_t time = 0;
+    while (fscanf(input, "%u", &sample) == 1)
+        FlashLogBlockAdd(&block, tag, (uint16_t)sample, time++);
+    FlashLogBlockFlush(&block, tag);
+    fclose(input);
+    return 0;
+}
+
+static void Dump(void) {
+    FlashLogCursor cursor;
+    const uint8_t *record;
+    uint32_t length;
+    FlashLogRewind(&cursor);
+    while ((length = FlashLogNext(&cursor, &record)) > 0) {
+        uint32_t header, time;
+        memcpy(&header, record, 4);
+        memcpy(&time, record + 4, 4);
+        printf("[%10u] tag %u, %u bytes:", time, (header >> 16) & 0xFF, length - 8);
+        for (uint32_t i = 8; i + 1 < length; i += 2)
+            printf(" %u", record[i] | (record[i + 1] << 8));
+        printf("\n");
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "uso: %s log.bin capture amostras.txt [tag] | dump | erase\n", argv[0]);
+        return 1;
+    }
+    if (!FlashLogOpenFile(argv[1])) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    int result = 0;
+    if (strcmp(argv[2], "capture") == 0 && argc > 3)
+        result = Capture(argv[3], (argc > 4) ? (uint8_t)strtoul(argv[4], NULL, 10) : 0);
+    else if (strcmp(argv[2], "dump") == 0)
+        Dump();
+    else if (strcmp(argv[2], "erase") == 0)
+        FlashLogErase();
+    else
+        result = 1;
+
+    FlashLogStats stats;
+    FlashLogGetStats(&stats);
+    fprintf(stderr, "%u registros gravados, %u setores apagados, %u falhas, %u bytes em uso, setor %u\n",
+            stats.records, stats.erases, stats.failures, stats.usedBytes, stats.sequence);
+    return result;
+}
@@ -0,0 +1,131 @@
+#include "link.hpp"
+
+namespace uartlink {
+
+namespace {
+
+uint32_t Get32(const uint8_t *p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+uint16_t Get16(const uint8_t *p) {
+    return uint16_t(p[0] | (p[1] << 8));
+}
+
+} // namespace
+
+uint16_t Crc16(const uint8_t *data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= uint16_t(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? uint16_t((crc << 1) ^ 0x1021) : uint16_t(crc << 1);
+    }
+    return crc;
+}
+
+bool CobsDecode(const uint8_t *data, size_t length, std::vector<uint8_t> &out) {
+    out.clear();
+    size_t i = 0;
+    while (i < length) {
+        uint8_t code = data[i++];
+        if (code == 0 || i + code - 1 > length)
+            return false;
+        out.insert(out.end(), data + i, data + i + code - 1);
+        i += code - 1;
+        if (code != 0xFF && i < length)
+            out.push_back(0);
+    }
+    return true;
+}
+
+void Demux::OnChannel(uint8_t channel, Handler handler) {
+    handlers_[channel] = std::move(handler);
+}
+
+void Demux::Feed(const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != 0) {
+            // Lixo sem delimitador (ex.: texto de antes do 'link on') e descartado inteiro
+            if (encoded_.size() > PAYLOAD_MAX + 8)
+                overflow_ = true;
+            else
+                encoded_.push_back(data[i]);
+            continue;
+        }
+        if (overflow_)
+            stats_.malformed++;
+        else if (!encoded_.empty())
+            Deliver();
+        encoded_.clear();
+        overflow_ = false;
+    }
+}
+
+void Demux::Deliver() {
+    if (!CobsDecode(encoded_.data(), encoded_.size(), decoded_) || decoded_.size() < 3) {
+        stats_.malformed++;
+        return;
+    }
+    size_t body = decoded_.size() - 2;
+    uint16_t crc = Get16(decoded_.data() + body);
+    if (Crc16(decoded_.data(), body) != crc) {
+        stats_.crcErrors++;
+        return;
+    }
+    const Handler &handler = handlers_[decoded_[0]];
+    if (!handler) {
+        stats_.unhandled++;
+        return;
+    }
+    stats_.frames++;
+    handler(decoded_.data() + 1, body - 1);
+}
+
+bool ParseLogRecord(const uint8_t *payload, size_t length, LogRecord &record) {
+    if (length < 7)
+        return false;
+    record = LogRecord{};
+    record.id = Get16(payload);
+    record.nargs = payload[2];
+    record.time = Get32(payload + 3);
+    if (record.nargs > 3 || length != 7 + 4u * record.nargs)
+        return false;
+    for (uint8_t i = 0; i < record.nargs; i++)
+        record.args[i] = Get32(payload + 7 + 4 * i);
+    return true;
+}
+
+bool ParseResponseRecord(const uint8_t *payload, size_t length, ResponseRecord &record) {
+    if (length != 12)
+        return false;
+    record.source = payload[0];
+    record.kind = payload[1];
+    record.engine = payload[2];
+    record.count = payload[3];
+    record.value = Get32(payload + 4);
+    record.cycles = Get32(payload + 8);
+    return true;
+}
+
+bool ParseLdrSample(const uint8_t *payload, size_t length, LdrSample &sample) {
+    if (length != 8)
+        return false;
+    sample.time = Get32(payload);
+    sample.ldr = Get16(payload + 4);
+    sample.duty = Get16(payload + 6);
+    return true;
+}
+
+bool ParseCaptureRecord(const uint8_t *payload, size_t length, CaptureRecord &record) {
+    if (length < 8)
+        return false;
+    uint32_t header = Get32(payload);
+    if ((header >> 24) != 0xA5 || (header & 0xFFFF) != length - 8)
+        return false;
+    record.tag = uint8_t(header >> 16);
+    record.time = Get32(payload + 4);
+    record.payload.assign(payload + 8, payload + length);
+    return true;
+}
+
+} // namespace uartlink
@@ -0,0 +1,99 @@
+// Lado do PC da camada de enlace da UART0 (common/link.h): junta os bytes ate cada 0x00,
+// desfaz o COBS, confere o CRC-16/CCITT-FALSE e entrega o payload ao handler do canal.
+// Tambem traz a leitura dos registros binarios que os firmwares mandam em cada canal.
+#ifndef HOST_LINK_HPP
+#define HOST_LINK_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace uartlink {
+
+// Mesmos valores de LinkChannel
+enum Channel : uint8_t {
+    CHANNEL_CONTROL = 0,
+    CHANNEL_TELEMETRY,
+    CHANNEL_RESULTS,
+    CHANNEL_LOGS,
+    CHANNEL_CAPTURE,
+    CHANNEL_COUNT
+};
+
+constexpr size_t PAYLOAD_MAX = 250;     // LINK_PAYLOAD_MAX
+
+uint16_t Crc16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+
+// Decodifica um quadro sem o delimitador; false se o COBS estiver malformado
+bool CobsDecode(const uint8_t *data, size_t length, std::vector<uint8_t> &out);
+
+class Demux {
+public:
+    using Handler = std::function<void(const uint8_t *payload, size_t length)>;
+
+    struct Stats {
+        uint64_t frames = 0;        // Quadros entregues
+        uint64_t crcErrors = 0;
+        uint64_t malformed = 0;     // COBS invalido, curto ou longo demais
+        uint64_t unhandled = 0;     // Canal sem handler
+    };
+
+    void OnChannel(uint8_t channel, Handler handler);
+
+    // Aceita a entrada em pedacos de qualquer tamanho, como chegam da porta serial
+    void Feed(const uint8_t *data, size_t length);
+
+    const Stats &GetStats() const { return stats_; }
+
+private:
+    void Deliver();
+
+    std::array<Handler, 256> handlers_;
+    std::vector<uint8_t> encoded_;
+    std::vector<uint8_t> decoded_;
+    bool overflow_ = false;
+    Stats stats_;
+};
+
+// LINK_CH_LOGS: registro do log adiado (common/dlog.h)
+struct LogRecord {
+    uint16_t id;
+    uint32_t time;          // Ciclos do DWT no alvo
+    uint8_t nargs;
+    uint32_t args[3];
+};
+bool ParseLogRecord(const uint8_t *payload, size_t length, LogRecord &record);
+
+// LINK_CH_RESULTS do projeto raiz: ResponseData (12 bytes)
+struct ResponseRecord {
+    uint8_t source;
+    uint8_t kind;
+    uint8_t engine;
+    uint8_t count;
+    uint32_t value;
+    uint32_t cycles;
+};
+bool ParseResponseRecord(const uint8_t *payload, size_t length, ResponseRecord &record);
+
+// LINK_CH_TELEMETRY do Lab2: tLDRSample (8 bytes)
+struct LdrSample {
+    uint32_t time;
+    uint16_t ldr;
+    uint16_t duty;
+};
+bool ParseLdrSample(const uint8_t *payload, size_t length, LdrSample &sample);
+
+// LINK_CH_CAPTURE: registro do log em flash (common/flash_log.h) como esta na flash,
+// cabecalho e tempo incluidos; o payload dos blocos de captura sao amostras de 16 bits
+struct CaptureRecord {
+    uint8_t tag;
+    uint32_t time;
+    std::vector<uint8_t> payload;
+};
+bool ParseCaptureRecord(const uint8_t *payload, size_t length, CaptureRecord &record);
+
+} // namespace uartlink
+
+#endif // HOST_LINK_HPP
@@ -0,0 +1,83 @@
+// Mostra no terminal o que chega pela UART0 em quadros (common/link.h): o canal de controle
+// sai como texto, os outros sao decodificados linha a linha com o nome do canal.
+//
+// Compile uma vez por aplicacao; com o log_formats.h dela no include path os logs viram texto:
+//   c++ -std=c++17 -I common -I UART_SYSTICK -o link_cat host/link.cpp host/link_cat.cpp
+//   stty -F /dev/ttyACM0 115200 raw && ./link_cat < /dev/ttyACM0
+// No projeto raiz mande "link on" antes (o padrao la e texto livre).
+#include <cstdio>
+#include "link.hpp"
+
+#if __has_include("log_formats.h")
+#include "log_formats.h"
+static const char *const formats[LOG_COUNT] = { LOG_FORMATS(DLOG_STRING) };
+#define HAVE_LOG_FORMATS 1
+#endif
+
+static constexpr double CYCLES_PER_US = 120.0;   // Clock de 120 MHz dos projetos
+
+int main() {
+    uartlink::Demux demux;
+
+    demux.OnChannel(uartlink::CHANNEL_CONTROL, [](const uint8_t *payload, size_t length) {
+        std::fwrite(payload, 1, length, stdout);
+    });
+    demux.OnChannel(uartlink::CHANNEL_TELEMETRY, [](const uint8_t *payload, size_t length) {
+        uartlink::LdrSample sample;
+        if (uartlink::ParseLdrSample(payload, length, sample)) {
+            std::printf("[telemetry %10u] ldr %u duty %u\n", sample.time, sample.ldr, sample.duty);
+        } else {
+            std::printf("[telemetry] %zu bytes\n", length);
+        }
+    });
+    demux.OnChannel(uartlink::CHANNEL_RESULTS, [](const uint8_t *payload, size_t length) {
+        uartlink::ResponseRecord r;
+        if (uartlink::ParseResponseRecord(payload, length, r)) {
+            std::printf("[results] source %u kind %u engine %u count %u value %u cycles %u (%.3f us)\n",
+                        r.source, r.kind, r.engine, r.count, r.value, r.cycles, r.cycles / CYCLES_PER_US);
+        } else {
+            std::printf("[results] %zu bytes\n", length);
+        }
+    });
+    demux.OnChannel(uartlink::CHANNEL_LOGS, [](const uint8_t *payload, size_t length) {
+        uartlink::LogRecord log;
+        if (!uartlink::ParseLogRecord(payload, length, log)) {
+            std::printf("[log] registro invalido (%zu bytes)\n", length);
+            return;
+        }
+#ifdef HAVE_LOG_FORMATS
+        if (log.id < LOG_COUNT) {
+            std::printf("[log %10u] ", log.time);
+            std::printf(formats[log.id], log.args[0], log.args[1], log.args[2]);
+            return;
+        }
+#endif
+        std::printf("[log %10u] id %u: %u %u %u\n", log.time, log.id, log.args[0], log.args[1], log.args[2]);
+    });
+    demux.OnChannel(uartlink::CHANNEL_CAPTURE, [](const uint8_t *payload, size_t length) {
+        uartlink::CaptureRecord capture;
+        if (length == 0) {
+            std::printf("[capture] fim do dump\n");
+        } else if (!uartlink::ParseCaptureRecord(payload, length, capture)) {
+            std::printf("[capture] registro invalido (%zu bytes)\n", length);
+        } else {
+            std::printf("[capture %10u] tag %u,", capture.time, capture.tag);
+            for (size_t i = 0; i + 1 < capture.payload.size(); i += 2)
+                std::printf(" %u", capture.payload[i] | (capture.payload[i + 1] << 8));
+            std::printf("\n");
+        }
+    });
+
+    uint8_t buffer[256];
+    size_t length;
+    while ((length = std::fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+        demux.Feed(buffer, length);
+        std::fflush(stdout);
+    }
+
+    const uartlink::Demux::Stats &stats = demux.GetStats();
+    std::fprintf(stderr, "%llu quadros, %llu com CRC errado, %llu malformados, %llu sem handler\n",
+                 (unsigned long long)stats.frames, (unsigned long long)stats.crcErrors,
+                 (unsigned long long)stats.malformed, (unsigned long long)stats.unhandled);
+    return 0;
+}
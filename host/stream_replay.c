@@ -0,0 +1,38 @@
+// Roda o processamento por bloco do common/adc_stream sobre amostras gravadas, sem placa:
+//   cc -std=c11 -I common -o stream_replay common/adc_stream.c host/stream_replay.c
+//   ./stream_replay amostras.txt [amostras por bloco]
+// O arquivo tem um valor de 0 a 4095 por linha (ou separados por espaco).
+#include <stdio.h>
+#include <stdlib.h>
+#include "adc_stream.h"
+
+static unsigned long blocks;
+
+static void BlockReady(const uint16_t *block, uint32_t count) {
+    AdcBlockSummary summary;
+    AdcStreamSummarize(block, count, &summary);
+    AdcStreamRelease(block);
+    printf("bloco %5lu: min %4u max %4u media %4u\n", blocks++, summary.min, summary.max, summary.sum / count);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s amostras.txt [amostras por bloco]\n", argv[0]);
+        return 1;
+    }
+    uint32_t length = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 10) : 256;
+    if (!AdcStreamInit(0, 1, length, BlockReady)) {
+        fprintf(stderr, "bloco de 1 a %u amostras\n", ADC_STREAM_BLOCK_MAX);
+        return 1;
+    }
+    if (!AdcStreamOpenFile(argv[1])) {
+        perror(argv[1]);
+        return 1;
+    }
+    AdcStreamStart();
+
+    AdcStreamStats stats;
+    AdcStreamGetStats(&stats);
+    fprintf(stderr, "%u blocos, %u overruns\n", stats.blocks, stats.overruns);
+    return 0;
+}
@@ -2,65 +2,462 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "cmsis_os2.h"
 #include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/gpio.h"
 #include "driverlib/uart.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/interrupt.h"
+#include "driverlib/udma.h"
+#include "fibonacci.h"
+#include "fib_bignum.h"
+#include "timing.h"
+#include "uart_tx.h"
+#include "uart_rx.h"
+#include "cmd_parser.h"
+#include "link.h"
+#include "msg_queue.h"
 
-osMessageQueueId_t queueFibonacciRecursiveHigh;
-osMessageQueueId_t queueFibonacciRecursiveLow;
-osMessageQueueId_t queueResp;
+MsgQueue queueFibonacciRecursiveHigh;
+MsgQueue queueFibonacciRecursiveLow;
+MsgQueue queueResp;
+MsgQueue queueMemoPrefetch;
+MsgQueue queueFibonacciBig;
+static MsgQueue *const reportedQueues[] = {     // Reported by 'stats', indexed by the record's count
+    &queueFibonacciRecursiveHigh, &queueFibonacciRecursiveLow, &queueFibonacciBig, &queueMemoPrefetch, &queueResp
+};
+#define QUEUE_COUNT (sizeof(reportedQueues) / sizeof(reportedQueues[0]))
+osMutexId_t uartMutex;  // Keeps streamed big results and result lines from interleaving
+osSemaphoreId_t uartDmaIdle;   // Released by the UART ISR when a uDMA block has been sent
+osThreadId_t parserThreadId;    // Woken by the UART ISR when a line (or half a ring) has arrived
+volatile bool uartFramed = false;   // 'link on': COBS frames (common/link.h) instead of text; set by the writer
 
+#define FIB_BATCH_MAX_SPANS 8  // Comma-separated items per request line
+#define FIB_BATCH_MAX_VALUES 64 // Values per request line, all ranges together
+#define FIB_INFLIGHT_SLOTS  8  // Requests tracked (for coalescing and cancellation) while they run
+#define FIB_NO_SLOT         0xFF
+#define FIB_BENCH_REPEAT    10 // Repetitions of a benchmark run
+#define FIB_RECURSIVE_MAX_N 32 // Deepest recursive baseline: n frames must fit the worker's OS_STACK_SIZE
+#define TX_BENCH_LINES      4  // 64-byte lines sent by 'txbench' (must fit the TX ring)
+#define UART_BLOCK_SIZE     UART_TX_DMA_MAX // Each of the writer's two uDMA output blocks
+#define UART_LINE_MAX       256             // Room kept for one more formatted response
+
+#define FIB_REQ_BENCHMARK   0x01    // Repeat FIB_BENCH_REPEAT times on both workers
+
+#define FIB_QUEUE_DEPTH     10      // Requests waiting per worker; size these from 'stats'
+#define FIB_DISPATCH_TIMEOUT 100    // Ticks the parser waits for room in a full worker queue
+#define FIB_DEADLINE_MAX_TICKS 0x7FFFFFFFu  // Longest @deadline the signed tick compare can hold
+#define BIG_QUEUE_DEPTH     4
+#define PREFETCH_QUEUE_DEPTH 8
+#define RESP_QUEUE_DEPTH    20      // Records waiting for the writer
+
+#define RX_FLAG_DATA        0x0001  // Parser thread flag set from the UART ISR
+#define PARSE_BENCH_ROUNDS  16      // Passes over the sample lines in 'parsebench'
+#define LETTER(c)           (1u << ((c) - 'a'))
+#define FIB_PREFIX_LETTERS  (LETTER('g') | LETTER('x') | LETTER('b') | LETTER('i') | LETTER('d') | LETTER('m'))
+
+// One item of a request line: a single n (first == last) or a range first-last
+typedef struct {
+    uint32_t first;
+    uint32_t last;
+} FibSpan;
+
+typedef struct {
+    FibEngine engine;   // FIB_ENGINE_AUTO, or forced by the line prefix
+    uint8_t flags;      // FIB_REQ_*
+    uint8_t slot;       // In-flight slot, FIB_NO_SLOT if the table was full
+    uint32_t id;        // Shown in every response, used by 'cancel <id>'
+    uint32_t spanCount;
+    FibSpan spans[FIB_BATCH_MAX_SPANS];
+} FibRequest;
+
+typedef enum {
+    RESP_SOURCE_HIGH = 0,
+    RESP_SOURCE_LOW,
+    RESP_SOURCE_BIG,
+    RESP_SOURCE_DISPATCHER,
+    RESP_SOURCE_COUNT
+} ResponseSource;
+
+// How to read value/cycles of a record. A single-value result is BEGIN, RESULT and,
+// for benchmark runs (count > 1), SPREAD and TAIL; the formatter joins them into one line.
+typedef enum {
+    RESP_BEGIN = 0,     // value = request id, cycles = n, count = coalesced duplicates
+    RESP_RESULT,        // value = F(n), cycles = p50, count = repetitions
+    RESP_SPREAD,        // value = min cycles, cycles = max cycles
+    RESP_TAIL,          // value = mean cycles, cycles = p99 cycles
+    RESP_BATCH_BEGIN,   // value = request id: opens a compact batch line
+    RESP_BATCH_ITEM,    // value = F(n), cycles = n
+    RESP_BATCH_LAST,    // value = F(n), cycles = n: ends the batch line
+    RESP_ACCEPTED,      // value = request id, cycles = id it attached to (0 = queued)
+    RESP_CANCELLED,     // value = request id: stopped by 'cancel <id>'
+    RESP_EXPIRED,       // value = request id: deadline passed before or while it ran
+    RESP_TX_BENCH,      // 'txbench': the writer compares blocking and ring-buffered output
+    RESP_PARSE_BENCH,   // 'parsebench': value = mean parse cycles per line, cycles = worst line
+    RESP_LINK_MODE,     // 'link on|off': value = 1 when the output switches to framed records
+    RESP_QUEUE_STATS,   // 'stats': count = queue index (QUEUE_COUNT: totals), engine = line (0 summary, 1 put wait, 2 get wait)
+    RESP_BUSY,          // value = request id: rejected, count = 0 no in-flight slot, 1 worker queues full
+    RESP_NOT_FOUND      // value = id given to 'cancel': not queued or running (finished, unknown or attached)
+} ResponseKind;
+
+// 12-byte record: no strings or floating point; the formatter converts to human units.
+// With 'link on' it goes out unchanged (little-endian) on LINK_CH_RESULTS.
 typedef struct {
-    uint32_t result;
-    double timeTaken;
-    char type[30];
+    uint8_t source;     // ResponseSource
+    uint8_t kind;       // ResponseKind
+    uint8_t engine;     // FibEngine of a result
+    uint8_t count;
+    uint32_t value;
+    uint32_t cycles;
 } ResponseData;
+_Static_assert(sizeof(ResponseData) == 12, "ResponseData must stay a 12-byte record");
+
+static const char *const responseSourceNames[RESP_SOURCE_COUNT] = {
+    "Fibonacci_High", "Fibonacci_Low", "Fibonacci_Big", "Dispatcher"
+};
+
+// A queued or running request; identical single-value requests attach here instead of queueing new work
+typedef struct {
+    bool active;
+    bool single;        // One value, no benchmark: eligible for coalescing
+    uint32_t id;
+    uint32_t n;
+    FibEngine engine;
+    uint32_t attached;
+    uint32_t refs;      // Workers that still hold the request
+    FibCancel cancel;
+} InFlightRequest;
+
+InFlightRequest inFlight[FIB_INFLIGHT_SLOTS];   // Written by the parser thread, released by the workers
+uint32_t nextRequestId = 1;
+volatile uint32_t requestsCancelled = 0;
+volatile uint32_t requestsExpired = 0;
 
 uint32_t SysClock;
-char inputBuffer[100];
-int bufferIndex = 0;
+CmdParser commandParser;    // Fed by the parser thread from the RX ring
+
+// Engine prefix letters: b = recursive baseline (benchmark only), i = iterative, d = fast
+// doubling, m = matrix. FIB_ENGINE_COUNT if more than one is given.
+static FibEngine EngineFromLetters(uint32_t letters) {
+    static const struct { char letter; FibEngine engine; } prefixes[] = {
+        {'b', FIB_ENGINE_RECURSIVE}, {'i', FIB_ENGINE_ITERATIVE}, {'d', FIB_ENGINE_FAST_DOUBLING}, {'m', FIB_ENGINE_MATRIX}
+    };
+    FibEngine engine = FIB_ENGINE_AUTO;
+    for (uint32_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+        if (letters & LETTER(prefixes[i].letter)) {
+            if (engine != FIB_ENGINE_AUTO)
+                return FIB_ENGINE_COUNT;
+            engine = prefixes[i].engine;
+        }
+    }
+    return engine;
+}
+
+// Parses the tokens of "10,20,30-40@500" into spans and an optional deadline in ms;
+// false if the line is malformed, has too many items or asks for more than FIB_BATCH_MAX_VALUES
+static bool ParseSpans(const CmdToken *tokens, uint32_t count, FibRequest *request, bool *hasDeadline, uint32_t *deadlineMs) {
+    uint32_t i = 0;
+    uint32_t values = 0;
+    request->spanCount = 0;
+    *hasDeadline = false;
+    while (i < count) {
+        if (tokens[i].type != CMD_TOKEN_NUMBER || request->spanCount == FIB_BATCH_MAX_SPANS)
+            return false;
+        FibSpan *span = &request->spans[request->spanCount++];
+        span->first = span->last = tokens[i++].value;
+        if (i < count && tokens[i].punct == '-') {
+            if (++i == count || tokens[i].type != CMD_TOKEN_NUMBER)
+                return false;
+            span->last = tokens[i++].value;
+            if (span->last < span->first)
+                return false;
+        }
+        if (span->last - span->first >= FIB_BATCH_MAX_VALUES - values)
+            return false;
+        values += span->last - span->first + 1;
+        if (i == count)
+            break;
+        if (tokens[i].punct == '@') {
+            if (i + 2 != count || tokens[i + 1].type != CMD_TOKEN_NUMBER)
+                return false;
+            *hasDeadline = true;
+            *deadlineMs = tokens[i + 1].value;
+            break;
+        }
+        if (tokens[i++].punct != ',')
+            return false;
+    }
+    return request->spanCount > 0;
+}
+
+// Called from the parser thread, which the workers cannot preempt: attaches to a running
+// identical request, or claims a slot for it
+static bool InFlightAttach(FibRequest *request, uint32_t refs, bool coalesce, uint32_t deadline, uint32_t *attachedTo) {
+    bool single = coalesce && request->spanCount == 1 && request->spans[0].first == request->spans[0].last;
+    uint8_t freeSlot = FIB_NO_SLOT;
+    for (uint8_t i = 0; i < FIB_INFLIGHT_SLOTS; i++) {
+        InFlightRequest *entry = &inFlight[i];
+        if (single && entry->active && entry->single && entry->n == request->spans[0].first &&
+            entry->engine == request->engine && entry->cancel.reason == FIB_CANCEL_NONE) {
+            entry->attached++;
+            *attachedTo = entry->id;
+            return true;
+        }
+        if (!entry->active && freeSlot == FIB_NO_SLOT)
+            freeSlot = i;
+    }
+    if (freeSlot != FIB_NO_SLOT) {
+        inFlight[freeSlot] = (InFlightRequest){.active = true, .single = single, .id = request->id,
+                                               .n = request->spans[0].first, .engine = request->engine, .refs = refs,
+                                               .cancel = {.reason = FIB_CANCEL_NONE, .deadline = deadline}};
+    }
+    request->slot = freeSlot;
+    return false;
+}
 
-uint32_t FibonacciRecursive(uint32_t n) {
-    if (n <= 1)
-        return n;
-    else
-        return FibonacciRecursive(n - 1) + FibonacciRecursive(n - 2);
+static FibCancel *InFlightCancel(uint8_t slot) {
+    return (slot == FIB_NO_SLOT) ? NULL : &inFlight[slot].cancel;
 }
 
+// Called by each worker that ran the request; returns how many duplicates were waiting on it
+static uint32_t InFlightComplete(uint8_t slot) {
+    uint32_t attached = 0;
+    if (slot == FIB_NO_SLOT)
+        return 0;
+    bool enabled = !IntMasterDisable();
+    if (--inFlight[slot].refs == 0) {
+        attached = inFlight[slot].attached;
+        inFlight[slot].active = false;
+    }
+    if (enabled)
+        IntMasterEnable();
+    return attached;
+}
+
+static bool CancelRequest(uint32_t id) {
+    bool found = false;
+    for (uint8_t i = 0; i < FIB_INFLIGHT_SLOTS; i++) {
+        if (inFlight[i].active && inFlight[i].id == id) {
+            inFlight[i].cancel.reason = FIB_CANCEL_REQUESTED;
+            found = true;
+        }
+    }
+    return found;
+}
+
+static void DispatchRequest(FibRequest *request, bool big, uint32_t deadline) {
+    bool benchmark = (request->flags & FIB_REQ_BENCHMARK) && !big;
+    uint32_t attachedTo = 0;
+    ResponseData ack = {.source = RESP_SOURCE_DISPATCHER, .kind = RESP_ACCEPTED, .value = request->id};
+    ResponseData busy = {.source = RESP_SOURCE_DISPATCHER, .kind = RESP_BUSY, .value = request->id};
+
+    if (InFlightAttach(request, benchmark ? 2 : 1, !big && !benchmark, deadline, &attachedTo)) {
+        ack.cycles = attachedTo;
+        MsgQueuePut(&queueResp, &ack, osWaitForever);
+        return;
+    }
+    // Without a slot neither the deadline nor 'cancel' could reach the request: reject it
+    if (request->slot == FIB_NO_SLOT) {
+        MsgQueuePut(&queueResp, &busy, osWaitForever);
+        return;
+    }
+
+    // A full queue holds the parser for at most FIB_DISPATCH_TIMEOUT, so a 'cancel' typed
+    // behind the request is read soon; a request that finds no room is rejected
+    uint32_t queued = 0;
+    if (big) {
+        queued += MsgQueuePut(&queueFibonacciBig, request, FIB_DISPATCH_TIMEOUT) == osOK;
+    } else if (benchmark) {
+        // Benchmarks run side by side on both workers
+        queued += MsgQueuePut(&queueFibonacciRecursiveHigh, request, FIB_DISPATCH_TIMEOUT) == osOK;
+        queued += MsgQueuePut(&queueFibonacciRecursiveLow, request, FIB_DISPATCH_TIMEOUT) == osOK;
+    } else {
+        MsgQueue *queue = (MsgQueueCount(&queueFibonacciRecursiveLow) < MsgQueueCount(&queueFibonacciRecursiveHigh))
+                          ? &queueFibonacciRecursiveLow : &queueFibonacciRecursiveHigh;
+        queued += MsgQueuePut(queue, request, FIB_DISPATCH_TIMEOUT) == osOK;
+    }
+    // Release the references of the queues that were full
+    for (uint32_t refs = benchmark ? 2 : 1; refs > queued; refs--)
+        InFlightComplete(request->slot);
+    busy.count = 1;
+    MsgQueuePut(&queueResp, (queued > 0) ? &ack : &busy, osWaitForever);
+}
+
+// "cancel <id>"
+static void CmdCancel(const CmdToken *args, uint32_t count, void *context) {
+    if (count == 1 && args[0].type == CMD_TOKEN_NUMBER && !CancelRequest(args[0].value)) {
+        ResponseData missing = {.source = RESP_SOURCE_DISPATCHER, .kind = RESP_NOT_FOUND, .value = args[0].value};
+        MsgQueuePut(&queueResp, &missing, osWaitForever);
+    }
+}
+
+static void CmdTxBench(const CmdToken *args, uint32_t count, void *context) {
+    ResponseData bench = {.source = RESP_SOURCE_DISPATCHER, .kind = RESP_TX_BENCH};
+    MsgQueuePut(&queueResp, &bench, osWaitForever);
+}
+
+// "link on" / "link off": the writer switches modes in order with the output already queued
+static void CmdLink(const CmdToken *args, uint32_t count, void *context) {
+    ResponseData mode = {.source = RESP_SOURCE_DISPATCHER, .kind = RESP_LINK_MODE};
+    if (count != 1)
+        return;
+    if (CmdTokenIs(&args[0], "on")) {
+        mode.value = 1;
+    } else if (!CmdTokenIs(&args[0], "off")) {
+        return;
+    }
+    MsgQueuePut(&queueResp, &mode, osWaitForever);
+}
+
+// "stats": three lines per queue and the total; the writer reads the counters as it formats
+static void CmdStats(const CmdToken *args, uint32_t count, void *context) {
+    for (uint32_t i = 0; i <= QUEUE_COUNT; i++) {
+        for (uint8_t line = 0; line < ((i < QUEUE_COUNT) ? 3 : 1); line++) {
+            ResponseData report = {.source = RESP_SOURCE_DISPATCHER, .kind = RESP_QUEUE_STATS, .engine = line, .count = i};
+            MsgQueuePut(&queueResp, &report, osWaitForever);
+        }
+    }
+}
+
+static void CmdNop(const CmdToken *args, uint32_t count, void *context) {
+}
+
+// Parse cost alone: the sample lines go through a parser whose handlers do nothing
+static void CmdParseBench(const CmdToken *args, uint32_t count, void *context) {
+    static const char sample[] = "10\r\ncancel 3\r\ng1000\r\nxb30@500\r\n1,2,3-9,40\r\ntxbench\r\nd100-120@2000\r\n";
+    static const CmdEntry nopCommands[] = {{"cancel", CmdNop}, {"txbench", CmdNop}, {"parsebench", CmdNop}, {"link", CmdNop}, {"stats", CmdNop}};
+    static CmdParser benchParser;
+    CmdParserStats stats;
+    CmdParserInit(&benchParser, nopCommands, sizeof(nopCommands) / sizeof(nopCommands[0]), CmdNop, NULL, 0);
+    for (int round = 0; round < PARSE_BENCH_ROUNDS; round++)
+        CmdParserFeed(&benchParser, sample, sizeof(sample) - 1);
+    CmdParserGetStats(&benchParser, &stats);
+    ResponseData bench = {.source = RESP_SOURCE_DISPATCHER, .kind = RESP_PARSE_BENCH,
+                          .value = stats.lines ? stats.cycles / stats.lines : 0, .cycles = stats.maxCycles};
+    MsgQueuePut(&queueResp, &bench, osWaitForever);
+}
+
+// Any line that is not a command: [prefixes]items[@deadline_ms]
+static void CmdFibonacci(const CmdToken *args, uint32_t count, void *context) {
+    FibRequest request = {.engine = FIB_ENGINE_AUTO};
+    bool big = false;
+    if (count > 0 && args[0].type == CMD_TOKEN_WORD) {
+        uint32_t letters = args[0].letters;
+        if (letters == 0 || (letters & ~FIB_PREFIX_LETTERS) != 0)
+            return;
+        big = (letters & LETTER('g')) != 0;     // Exact arbitrary-precision result
+        if (letters & LETTER('x'))
+            request.flags |= FIB_REQ_BENCHMARK;
+        request.engine = EngineFromLetters(letters);
+        if (request.engine == FIB_ENGINE_COUNT)
+            return;
+        if (request.engine == FIB_ENGINE_RECURSIVE)
+            request.flags |= FIB_REQ_BENCHMARK;
+        args++;
+        count--;
+    }
+
+    bool hasDeadline;
+    uint32_t ms;
+    uint32_t deadline = 0;
+    if (!ParseSpans(args, count, &request, &hasDeadline, &ms))
+        return;     // Malformed line: dropped
+    // Batch records carry n instead of cycles, so benchmark runs ('x', or the recursive
+    // baseline) only make sense on a single value
+    bool batch = request.spanCount > 1 || request.spans[0].first != request.spans[0].last;
+    if (batch && (request.flags & FIB_REQ_BENCHMARK) && !big)
+        return;
+    // The recursive baseline nests n calls deep: a large n would overflow the worker stack
+    // long before the cancel token or the deadline could stop it
+    if (request.engine == FIB_ENGINE_RECURSIVE && !big && request.spans[0].first > FIB_RECURSIVE_MAX_N)
+        return;
+    if (hasDeadline) {
+        uint64_t ticks = (uint64_t)ms * osKernelGetTickFreq() / 1000;
+        deadline = osKernelGetTickCount() + (uint32_t)((ticks > FIB_DEADLINE_MAX_TICKS) ? FIB_DEADLINE_MAX_TICKS : ticks);
+        if (deadline == 0)
+            deadline = 1;   // 0 means "no deadline"
+    }
+
+    request.id = nextRequestId++;
+    DispatchRequest(&request, big, deadline);
+}
+
+static const CmdEntry commands[] = {
+    {"cancel", CmdCancel},
+    {"txbench", CmdTxBench},
+    {"parsebench", CmdParseBench},
+    {"link", CmdLink},
+    {"stats", CmdStats},
+};
+
+// Only moves bytes: the RX FIFO into the RX ring, the TX ring into the TX FIFO
 void UARTIntHandler(void) {
     uint32_t status = UARTIntStatus(UART0_BASE, true);
     UARTIntClear(UART0_BASE, status);
-    char receivedChar;
-
-    while (UARTCharsAvail(UART0_BASE)) {
-        receivedChar = (char)UARTCharGet(UART0_BASE);
-        if (receivedChar == '\r' || receivedChar == '\n') {
-            if (bufferIndex > 0) {
-                inputBuffer[bufferIndex] = '\0';
-                uint32_t num = strtoul(inputBuffer, NULL, 10);
-                osMessageQueuePut(queueFibonacciRecursiveHigh, &num, 0, 0);
-                osMessageQueuePut(queueFibonacciRecursiveLow, &num, 0, 0);
-                bufferIndex = 0;
-            }
-        } else if (receivedChar >= '0' && receivedChar <= '9') {
-            if (bufferIndex < sizeof(inputBuffer) - 1) {
-                inputBuffer[bufferIndex++] = receivedChar;
-            }
+    UartTxIntHandler();
+    UartRxIntHandler();
+}
+
+static void UartRxLineReady(void) {
+    if (parserThreadId != NULL)
+        osThreadFlagsSet(parserThreadId, RX_FLAG_DATA);
+}
+
+// Feeds the RX ring to the command parser in place and dispatches complete lines. Runs
+// above the workers so that the in-flight table is updated atomically with respect to them.
+void Thread_CommandParser(void *argument) {
+    CmdParserInit(&commandParser, commands, sizeof(commands) / sizeof(commands[0]), CmdFibonacci, NULL, 0);
+    while (true) {
+        const char *data;
+        uint32_t length;
+        osThreadFlagsWait(RX_FLAG_DATA, osFlagsWaitAny, osWaitForever);
+        while ((length = UartRxPeek(&data)) > 0) {
+            CmdParserFeed(&commandParser, data, length);
+            UartRxConsume(length);
         }
     }
 }
 
+// Queues everything on the TX ring; a thread sleeps while the ring is full instead of spinning.
+// Framed text goes out on the control channel, LINK_SEND_MAX bytes per frame.
+void UARTSendBuffer(const char *data, uint32_t length) {
+    while (length > 0) {
+        uint32_t sent;
+        bool full;
+        if (uartFramed) {
+            uint32_t chunk = (length < LINK_SEND_MAX) ? length : LINK_SEND_MAX;
+            sent = LinkSend(LINK_CH_CONTROL, data, chunk) ? chunk : 0;
+            full = sent == 0;
+        } else {
+            sent = UartTxWrite(data, length);
+            full = sent < length;
+        }
+        data += sent;
+        length -= sent;
+        if (full && osKernelGetState() == osKernelRunning)
+            osDelay(1);
+    }
+}
+
+void UARTSendString(const char *str) {
+    UARTSendBuffer(str, strlen(str));
+}
+
+static void UartDmaDone(void) {
+    osSemaphoreRelease(uartDmaIdle);
+}
+
 void SetupUart(void) {
     SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
     while (!SysCtlPeripheralReady(SYSCTL_PERIPH_UART0));
     UARTConfigSetExpClk(UART0_BASE, SysClock, 115200,
                         (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
-    UARTFIFODisable(UART0_BASE);
-    UARTIntEnable(UART0_BASE, UART_INT_RX);
+    UartTxInit(UART0_BASE, INT_UART0);
+    UartTxDmaInit(UDMA_CH9_UART0TX, UartDmaDone);
+    UartRxInit(UART0_BASE, UartRxLineReady);
     UARTIntRegister(UART0_BASE, UARTIntHandler);
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
     while (!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOA));
@@ -69,55 +466,388 @@ void SetupUart(void) {
     GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
 }
 
+static void PutResponse(ResponseSource source, ResponseKind kind, uint32_t value, uint32_t cycles, uint8_t engine, uint8_t count) {
+    ResponseData response = {.source = source, .kind = kind, .engine = engine, .count = count, .value = value, .cycles = cycles};
+    MsgQueuePut(&queueResp, &response, osWaitForever);
+}
+
+// Reports a request stopped by its cancel token (before or during the work)
+static void ReportCancelled(const FibRequest *request, FibCancel *cancel, ResponseSource source) {
+    ResponseKind kind;
+    bool enabled = !IntMasterDisable();
+    if (cancel->reason == FIB_CANCEL_EXPIRED) {
+        kind = RESP_EXPIRED;
+        requestsExpired++;
+    } else {
+        kind = RESP_CANCELLED;
+        requestsCancelled++;
+    }
+    if (enabled)
+        IntMasterEnable();
+    PutResponse(source, kind, request->id, 0, 0, 0);
+}
+
+// Computes every value of a request; a batch becomes a run of compact records
+static void ServeFibonacciRequest(const FibRequest *request, ResponseSource source) {
+    int repeat = (request->flags & FIB_REQ_BENCHMARK) ? FIB_BENCH_REPEAT : 1;
+    bool batch = request->spanCount > 1 || request->spans[0].first != request->spans[0].last;
+    FibCancel *cancel = InFlightCancel(request->slot);
+
+    // Requests that expired (or were cancelled) in the queue are rejected before any work
+    if (FibCancelPoll(cancel)) {
+        ReportCancelled(request, cancel, source);
+        InFlightComplete(request->slot);
+        return;
+    }
+    if (batch)
+        PutResponse(source, RESP_BATCH_BEGIN, request->id, 0, 0, 0);
+    for (uint32_t s = 0; s < request->spanCount; s++) {
+        uint32_t n = request->spans[s].first;
+        do {
+            TimingSamples samples;
+            TimingSummary cycles;
+            FibEngine engine;
+            uint32_t result = 0;
+            TimingSamplesReset(&samples);
+            for (int i = 0; i < repeat; i++) {
+                uint32_t start = TimingNow();
+                result = FibonacciCompute(n, request->engine, &engine, cancel);
+                TimingSamplesAdd(&samples, TimingNow() - start);
+            }
+            if (FibCancelPoll(cancel)) {
+                ReportCancelled(request, cancel, source);
+                InFlightComplete(request->slot);
+                return;
+            }
+            TimingSummarize(&samples, &cycles);
+            if (batch) {
+                bool last = s == request->spanCount - 1 && n == request->spans[s].last;
+                PutResponse(source, last ? RESP_BATCH_LAST : RESP_BATCH_ITEM, result, n, engine, 1);
+            } else {
+                uint32_t coalesced = InFlightComplete(request->slot);
+                PutResponse(source, RESP_BEGIN, request->id, n, engine, coalesced > 255 ? 255 : coalesced);
+                PutResponse(source, RESP_RESULT, result, cycles.p50, engine, cycles.count);
+                if (cycles.count > 1) {
+                    PutResponse(source, RESP_SPREAD, cycles.min, cycles.max, engine, cycles.count);
+                    PutResponse(source, RESP_TAIL, cycles.mean, cycles.p99, engine, cycles.count);
+                }
+            }
+            MsgQueuePut(&queueMemoPrefetch, &n, 0);
+        } while (n++ != request->spans[s].last);
+    }
+    if (batch)
+        InFlightComplete(request->slot);
+}
+
 void Thread_FibonacciRecursiveHigh(void *argument) {
-    uint32_t num;
+    FibRequest request;
     while (true) {
-        osStatus_t status = osMessageQueueGet(queueFibonacciRecursiveHigh, &num, NULL, osWaitForever);
+        osStatus_t status = MsgQueueGet(&queueFibonacciRecursiveHigh, &request, osWaitForever);
         if (status == osOK) {
-            for (int i = 0; i < 10; i++) { // Calculate Fibonacci 10 times
-                uint32_t result;
-                uint32_t start = osKernelGetTickCount();
-                result = FibonacciRecursive(num);
-                uint32_t end = osKernelGetTickCount();
-                ResponseData response = {.result = result, .timeTaken = (double)(end - start) / osKernelGetTickFreq()};
-                snprintf(response.type, sizeof(response.type), "Fibonacci_High");
-                osMessageQueuePut(queueResp, &response, 0, osWaitForever);
-            }
+            ServeFibonacciRequest(&request, RESP_SOURCE_HIGH);
         }
     }
 }
 
 void Thread_FibonacciRecursiveLow(void *argument) {
-    uint32_t num;
+    FibRequest request;
     while (true) {
-        osStatus_t status = osMessageQueueGet(queueFibonacciRecursiveLow, &num, NULL, osWaitForever);
+        osStatus_t status = MsgQueueGet(&queueFibonacciRecursiveLow, &request, osWaitForever);
         if (status == osOK) {
-            for (int i = 0; i < 10; i++) { // Calculate Fibonacci 10 times
-                uint32_t result;
-                uint32_t start = osKernelGetTickCount();
-                result = FibonacciRecursive(num);
-                uint32_t end = osKernelGetTickCount();
-                ResponseData response = {.result = result, .timeTaken = (double)(end - start) / osKernelGetTickFreq()};
-                snprintf(response.type, sizeof(response.type), "Fibonacci_Low");
-                osMessageQueuePut(queueResp, &response, 0, osWaitForever);
+            ServeFibonacciRequest(&request, RESP_SOURCE_LOW);
+        }
+    }
+}
+
+// Runs below the workers, so neighbours of recent requests are filled only while they idle
+void Thread_MemoPrefetch(void *argument) {
+    uint32_t num;
+    while (true) {
+        if (MsgQueueGet(&queueMemoPrefetch, &num, osWaitForever) == osOK) {
+            FibMemoPrecompute(num);
+        }
+    }
+}
+
+static void EmitBigDigits(const char *digits, uint32_t length) {
+    UARTSendBuffer(digits, length);
+}
+
+// Exact F(n) for large n, streamed to the UART as the digits are produced
+void Thread_FibonacciBig(void *argument) {
+    FibRequest request;
+    while (true) {
+        if (MsgQueueGet(&queueFibonacciBig, &request, osWaitForever) == osOK) {
+            FibCancel *cancel = InFlightCancel(request.slot);
+            for (uint32_t s = 0; s < request.spanCount && !FibCancelPoll(cancel); s++) {
+                uint32_t num = request.spans[s].first;
+                do {
+                    char buffer[60];
+                    uint32_t digits = 0;
+                    osMutexAcquire(uartMutex, osWaitForever);
+                    snprintf(buffer, sizeof(buffer), "#%u F(%u) = ", request.id, num);
+                    UARTSendString(buffer);
+                    uint32_t start = TimingNow();
+                    FibBigStatus status = FibonacciBigStream(num, EmitBigDigits, &digits, cancel);
+                    uint32_t cycles = TimingNow() - start;
+                    if (status == FIB_BIG_OK) {
+                        snprintf(buffer, sizeof(buffer), " (%u digits - %.1f us)\r\n", digits, TimingCyclesToMicroseconds(cycles));
+                    } else if (status == FIB_BIG_TOO_LARGE) {
+                        snprintf(buffer, sizeof(buffer), "error: n must be <= %u\r\n", FIB_BIG_MAX_N);
+                    } else if (status == FIB_BIG_CANCELLED) {
+                        snprintf(buffer, sizeof(buffer), "stopped\r\n");
+                    } else {
+                        snprintf(buffer, sizeof(buffer), "error: out of limb memory\r\n");
+                    }
+                    UARTSendString(buffer);
+                    osMutexRelease(uartMutex);
+                } while (num++ != request.spans[s].last && num <= FIB_BIG_MAX_N && !FibCancelPoll(cancel));
             }
+            if (FibCancelPoll(cancel))
+                ReportCancelled(&request, cancel, RESP_SOURCE_BIG);
+            InFlightComplete(request.slot);
+        }
+    }
+}
+
+// Parts of a single-value line collected per source until its last record arrives
+typedef struct {
+    uint32_t id;
+    uint32_t n;
+    uint32_t coalesced;
+    ResponseData result;
+    ResponseData spread;
+} PendingLine;
+
+static int FormatResultLine(char *buffer, size_t size, ResponseSource source, const PendingLine *line, const ResponseData *tail) {
+    char coalesced[24] = "";
+    FibMemoStats memo;
+    if (line->coalesced > 0) {
+        snprintf(coalesced, sizeof(coalesced), " +%u coalesced", line->coalesced);
+    }
+    FibMemoGetStats(&memo);
+    if (tail == NULL) {
+        return snprintf(buffer, size, "#%u Result = %u%s (%s/%s - %u cycles - %.3f us) memo %u/%u%s\r\n",
+                        line->id, line->result.value, line->n > 47 ? " mod 2^32" : "", responseSourceNames[source],
+                        FibonacciEngineName((FibEngine)line->result.engine), line->result.cycles,
+                        TimingCyclesToMicroseconds(line->result.cycles), memo.hits, memo.misses, coalesced);
+    }
+    return snprintf(buffer, size, "#%u Result = %u%s (%s/%s - x%u cycles min/mean/max/p50/p99 %u/%u/%u/%u/%u - p50 %.3f us) memo %u/%u%s\r\n",
+                    line->id, line->result.value, line->n > 47 ? " mod 2^32" : "", responseSourceNames[source],
+                    FibonacciEngineName((FibEngine)line->result.engine), line->result.count,
+                    line->spread.value, tail->value, line->spread.cycles, line->result.cycles, tail->cycles,
+                    TimingCyclesToMicroseconds(line->result.cycles), memo.hits, memo.misses, coalesced);
+}
+
+// Cycles the caller spends handing TX_BENCH_LINES lines to the UART: the old busy-wait
+// path (FIFO off), the TX ring and one uDMA block. Runs with uartMutex held. When framed,
+// each line is sent as a pre-built control frame so the host stream stays valid.
+static int RunTxBenchmark(char *buffer, size_t size) {
+    static const char text[] = "txbench 0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRS\r\n";
+    static char frame[LINK_FRAME_MAX(sizeof(text))];
+    static char block[TX_BENCH_LINES * sizeof(frame)];
+    const char *line = text;
+    uint32_t length = sizeof(text) - 1;
+    uint32_t ring = 0;
+    uint32_t blocking;
+    uint32_t dma;
+    uint32_t start;
+
+    if (uartFramed) {
+        length = LinkEncode(LINK_CH_CONTROL, text, length, (uint8_t *)frame);
+        line = frame;
+    }
+    UartTxFlush();
+    UARTFIFODisable(UART0_BASE);
+    start = TimingNow();
+    for (int i = 0; i < TX_BENCH_LINES; i++) {
+        for (uint32_t c = 0; c < length; c++)
+            UARTCharPut(UART0_BASE, line[c]);
+    }
+    blocking = TimingNow() - start;
+    while (UARTBusy(UART0_BASE));
+    UARTFIFOEnable(UART0_BASE);
+
+    for (int i = 0; i < TX_BENCH_LINES; i++) {
+        start = TimingNow();
+        UartTxWrite(line, length);
+        ring += TimingNow() - start;
+    }
+    UartTxFlush();
+
+    for (uint32_t i = 0; i < TX_BENCH_LINES * length; i++)
+        block[i] = line[i % length];
+    start = TimingNow();
+    UartTxDmaStart(block, TX_BENCH_LINES * length);
+    dma = TimingNow() - start;
+    UartTxFlush();
+    return snprintf(buffer, size, "TX bench %u bytes: blocking %u cycles (%.1f us), ring %u cycles (%.1f us), dma %u cycles (%.1f us)\r\n",
+                    TX_BENCH_LINES * length, blocking, TimingCyclesToMicroseconds(blocking),
+                    ring, TimingCyclesToMicroseconds(ring), dma, TimingCyclesToMicroseconds(dma));
+}
+
+// One line of the 'stats' report: counters, or the put/get wait histogram of a queue
+static int FormatQueueStats(char *buffer, size_t size, uint32_t index, uint32_t line) {
+    MsgQueueStats stats;
+    int length = 0;
+    if (index >= QUEUE_COUNT) {
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < QUEUE_COUNT; i++) {
+            MsgQueueGetStats(reportedQueues[i], &stats);
+            total += stats.memBytes;
         }
+        return snprintf(buffer, size, "Queues: %u bytes of OS_DYNAMIC_MEM_SIZE\r\n", total);
+    }
+
+    MsgQueueGetStats(reportedQueues[index], &stats);
+    if (line == 0) {
+        return snprintf(buffer, size, "Queue %s (%s): depth max %u/%u, %u bytes, puts %u, gets %u, drops %u, timeouts %u/%u\r\n",
+                        reportedQueues[index]->name, MsgQueuePolicyName(stats.policy), stats.highWater, stats.capacity,
+                        stats.memBytes, stats.puts, stats.gets, stats.drops, stats.putTimeouts, stats.getTimeouts);
     }
+    const uint32_t *wait = (line == 1) ? stats.putWait : stats.getWait;
+    length += snprintf(buffer, size, "  %s cycles:", (line == 1) ? "put" : "get");
+    for (uint32_t b = 0; b < MSGQ_HIST_BUCKETS; b++)
+        length += snprintf(buffer + length, size - length, " %s:%u", MsgQueueBucketName(b), wait[b]);
+    length += snprintf(buffer + length, size - length, "\r\n");
+    return length;
 }
 
+// Writer-thread state: lines assembled from several records, and the open batch line
+static PendingLine pendingLines[RESP_SOURCE_COUNT];
+static uint8_t batchOwner = RESP_SOURCE_COUNT;     // Source of the open batch line, RESP_SOURCE_COUNT when none
 
+// Appends the text for one record to buffer; returns the length written
+static int FormatResponse(const ResponseData *response, char *buffer, size_t size) {
+    int length = 0;
+    ResponseSource source = (ResponseSource)(response->source < RESP_SOURCE_COUNT ? response->source : RESP_SOURCE_DISPATCHER);
+    PendingLine *line = &pendingLines[source];
+    bool batchRecord = response->kind == RESP_BATCH_ITEM || response->kind == RESP_BATCH_LAST;
 
+    // Batch values from one source share a line; anything printed in between breaks it
+    bool prints = batchRecord || response->kind == RESP_BATCH_BEGIN || response->kind >= RESP_ACCEPTED ||
+                  response->kind == RESP_TAIL || (response->kind == RESP_RESULT && response->count <= 1);
+    if (batchOwner != RESP_SOURCE_COUNT && prints && (!batchRecord || batchOwner != source)) {
+        length += snprintf(buffer + length, size - length, "\r\n");
+        batchOwner = RESP_SOURCE_COUNT;
+    }
+
+    switch (response->kind) {
+        case RESP_BEGIN:
+            line->id = response->value;
+            line->n = response->cycles;
+            line->coalesced = response->count;
+            break;
+        case RESP_RESULT:
+            line->result = *response;
+            if (response->count <= 1)
+                length += FormatResultLine(buffer + length, size - length, source, line, NULL);
+            break;
+        case RESP_SPREAD:
+            line->spread = *response;
+            break;
+        case RESP_TAIL:
+            length += FormatResultLine(buffer + length, size - length, source, line, response);
+            break;
+        case RESP_BATCH_BEGIN:
+            length += snprintf(buffer + length, size - length, "#%u Batch %s:", response->value, responseSourceNames[source]);
+            batchOwner = source;
+            break;
+        case RESP_BATCH_ITEM:
+        case RESP_BATCH_LAST:
+            if (batchOwner != source) {
+                length += snprintf(buffer + length, size - length, "Batch %s:", responseSourceNames[source]);
+                batchOwner = source;
+            }
+            length += snprintf(buffer + length, size - length, " %u:%u%s", response->cycles, response->value, response->cycles > 47 ? "*" : "");
+            if (response->kind == RESP_BATCH_LAST) {
+                length += snprintf(buffer + length, size - length, "\r\n");
+                batchOwner = RESP_SOURCE_COUNT;
+            }
+            break;
+        case RESP_ACCEPTED:
+            if (response->cycles != 0) {
+                length += snprintf(buffer + length, size - length, "#%u attached to #%u\r\n", response->value, response->cycles);
+            } else {
+                length += snprintf(buffer + length, size - length, "#%u queued\r\n", response->value);
+            }
+            break;
+        case RESP_CANCELLED:
+        case RESP_EXPIRED:
+            length += snprintf(buffer + length, size - length, "#%u %s (%s) - cancelled %u, expired %u\r\n",
+                               response->value, response->kind == RESP_CANCELLED ? "cancelled" : "expired", responseSourceNames[source],
+                               requestsCancelled, requestsExpired);
+            break;
+        case RESP_TX_BENCH:
+            osMutexAcquire(uartMutex, osWaitForever);
+            length += RunTxBenchmark(buffer + length, size - length);
+            osMutexRelease(uartMutex);
+            break;
+        case RESP_PARSE_BENCH:
+            length += snprintf(buffer + length, size - length, "Parse bench: mean %u cycles/line (%.2f us), worst %u cycles\r\n",
+                               response->value, TimingCyclesToMicroseconds(response->value), response->cycles);
+            break;
+        case RESP_LINK_MODE:
+            length += snprintf(buffer + length, size - length, "Link framing off\r\n");
+            break;
+        case RESP_QUEUE_STATS:
+            length += FormatQueueStats(buffer + length, size - length, response->count, response->engine);
+            break;
+        case RESP_BUSY:
+            length += snprintf(buffer + length, size - length, "#%u rejected: %s\r\n", response->value,
+                               response->count ? "worker queues full" : "too many requests in flight");
+            break;
+        case RESP_NOT_FOUND:
+            length += snprintf(buffer + length, size - length, "#%u not found\r\n", response->value);
+            break;
+    }
+    return (length < (int)size) ? length : (int)size - 1;
+}
+
+// Framed mode: the record itself goes out on the results channel and the host does the
+// formatting; only the reports without a binary form (txbench, stats) still produce text
+static uint32_t EncodeResponse(const ResponseData *response, uint8_t *buffer) {
+    if (response->kind == RESP_TX_BENCH || response->kind == RESP_QUEUE_STATS) {
+        char text[UART_LINE_MAX - 16];
+        int length = FormatResponse(response, text, sizeof(text));
+        return LinkEncode(LINK_CH_CONTROL, text, length, buffer);
+    }
+    if (response->kind == RESP_LINK_MODE) {
+        buffer[0] = 0;      // Ends the text the host has buffered so this first frame is not lost
+        return 1 + LinkEncode(LINK_CH_RESULTS, response, sizeof(*response), buffer + 1);
+    }
+    return LinkEncode(LINK_CH_RESULTS, response, sizeof(*response), buffer);
+}
+
+// Drains every queued record into one output block and hands it to the uDMA; the next
+// block is formatted while this one is on the wire
 void Thread_UARTWrite(void *argument) {
+    static char blocks[2][UART_BLOCK_SIZE];
+    uint32_t current = 0;
     ResponseData response;
     while (true) {
-        if (osMessageQueueGet(queueResp, &response, NULL, osWaitForever) == osOK) {
-            char buffer[80];
-            snprintf(buffer, sizeof(buffer), "Result = %u (%s - %.8f seconds)\r\n", response.result, response.type, response.timeTaken < 0.000001 ? response.timeTaken * 1000000 : response.timeTaken);
-
-            for (char *p = buffer; *p; p++) {
-                UARTCharPut(UART0_BASE, *p);
+        char *block = blocks[current];
+        uint32_t used = 0;
+        if (MsgQueueGet(&queueResp, &response, osWaitForever) != osOK)
+            continue;
+        do {
+            if (response.kind == RESP_LINK_MODE)
+                uartFramed = response.value != 0;
+            if (uartFramed) {
+                used += EncodeResponse(&response, (uint8_t *)block + used);
+            } else {
+                used += FormatResponse(&response, block + used, UART_BLOCK_SIZE - used);
             }
-        }
+        } while (UART_BLOCK_SIZE - used >= UART_LINE_MAX && MsgQueueGet(&queueResp, &response, 0) == osOK);
+        if (used == 0)
+            continue;
+
+        osSemaphoreAcquire(uartDmaIdle, osWaitForever);
+        osMutexAcquire(uartMutex, osWaitForever);
+        while (!UartTxDmaStart(block, used))
+            osDelay(1);     // Big-number digits still draining from the TX ring
+        osMutexRelease(uartMutex);
+        current ^= 1;
     }
 }
 
@@ -125,10 +855,22 @@ int main(void) {
     SysClock = SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN | SYSCTL_USE_PLL | SYSCTL_CFG_VCO_240), 120000000);
 
     SetupUart();
+    TimingInit(SysClock);
+    if (FibonacciSelfTest() >= 0) {
+        UARTSendString("Fibonacci table does not match the engines\r\n");
+    }
+    FibonacciCalibrate();
     osKernelInitialize();
-    queueFibonacciRecursiveHigh = osMessageQueueNew(10, sizeof(uint32_t), NULL);
-    queueFibonacciRecursiveLow = osMessageQueueNew(10, sizeof(uint32_t), NULL);
-    queueResp = osMessageQueueNew(20, sizeof(ResponseData), NULL);
+    // Requests hold the parser for at most FIB_DISPATCH_TIMEOUT and are then rejected, and
+    // results block the workers (a line spans several records, so none may be lost): under
+    // load the compute path gives way to the UART. Prefetch hints are only hints: the newest ones win.
+    MsgQueueInit(&queueFibonacciRecursiveHigh, "FibHigh", FIB_QUEUE_DEPTH, sizeof(FibRequest), MSGQ_BLOCK);
+    MsgQueueInit(&queueFibonacciRecursiveLow, "FibLow", FIB_QUEUE_DEPTH, sizeof(FibRequest), MSGQ_BLOCK);
+    MsgQueueInit(&queueResp, "Resp", RESP_QUEUE_DEPTH, sizeof(ResponseData), MSGQ_BLOCK);
+    MsgQueueInit(&queueMemoPrefetch, "Prefetch", PREFETCH_QUEUE_DEPTH, sizeof(uint32_t), MSGQ_DROP_OLDEST);
+    MsgQueueInit(&queueFibonacciBig, "FibBig", BIG_QUEUE_DEPTH, sizeof(FibRequest), MSGQ_BLOCK);
+    uartMutex = osMutexNew(NULL);
+    uartDmaIdle = osSemaphoreNew(1, 1, NULL);
     
     osThreadId_t highThreadId = osThreadNew(Thread_FibonacciRecursiveHigh, NULL, NULL);
     osThreadId_t lowThreadId = osThreadNew(Thread_FibonacciRecursiveLow, NULL, NULL);
@@ -141,6 +883,14 @@ int main(void) {
         osThreadSetPriority(lowThreadId,  osPriorityNormal);
     }
     
+    osThreadId_t prefetchThreadId = osThreadNew(Thread_MemoPrefetch, NULL, NULL);
+    if (prefetchThreadId != NULL) {
+        osThreadSetPriority(prefetchThreadId, osPriorityLow);
+    }
+
+    const osThreadAttr_t parserAttr = {.name = "CommandParser", .priority = osPriorityAboveNormal};
+    parserThreadId = osThreadNew(Thread_CommandParser, NULL, &parserAttr);
+    osThreadNew(Thread_FibonacciBig, NULL, NULL);
     osThreadNew(Thread_UARTWrite, NULL, NULL);
     osKernelStart();
 